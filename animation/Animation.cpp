@@ -3,6 +3,9 @@
 #include "Animation.h"
 #include "../model/Model.h"
 #include "../common_utils/Logger.h"
+#include "../common_utils/ThreadPool.h"
+#include "../common_utils/FrameArena.h"
+#include "PoseKernels.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -22,17 +25,109 @@
 #include <filesystem>   // for std::filesystem
 #include <string>       // for std::string
 
+#include <set>
 #include <sstream>
-#include "../nlohmann/json.hpp"
+
+// Bones the post-bake jitter pass smooths: the right leg chain only
+static const std::set<std::string> postBakeTargets = {
+    "DEF-thigh.R", "DEF-shin.R", "DEF-foot.R", "DEF-toe.R"
+};
 
 
 Animation::Animation(const std::string& filePath,
-    const Model* model)
-    : name(filePath), modelRef(model)
+    const Model* model,
+    const CompressionSettings& compression,
+    bool keepPreSmoothKeys)
+    : name(filePath), compressionSettings(compression), modelRef(model)
 {
-    loadAnimation(filePath, model);
+    // Of the jitter config, the bake only reads the targets' profiles
+    const std::shared_ptr<const JitterConfig::Table> table = JitterConfig::shared().getTable();
+    const std::string configClip = JitterConfig::clipKey(filePath);
+    for (const std::string& bone : postBakeTargets)
+        bakeParams.postBakeProfiles.push_back(JitterConfig::resolve(*table, configClip, bone));
+
+    // Everything read from the model after the load is copied here, so a
+    // shared clip outlives the model that first loaded it
+    if (model)
+    {
+        for (const Bone& bone : model->getBones())
+            boneNames.push_back(bone.name);
+        boneReach = computeBoneReach(*model);
+    }
+
+    // The bake only depends on the inputs hashed into the key, so a
+    // matching cache entry is the clip loadAnimation would produce
+    const uint64_t cacheKey = BakedClipCache::isEnabled()
+        ? BakedClipCache::computeKey(filePath, model, bakeParams) : 0;
+
+    if (!loadFromCache(filePath, cacheKey))
+    {
+        loadAnimation(filePath, model);
+        if (!loaded)
+            return;     // import failed; callers check isLoaded()
+        saveToCache(filePath, cacheKey);
+    }
+    buildBoneTracks();
     loaded = true;
+    modelRef = nullptr;
+
+    JitterTrace::shared().replaceClip(JitterTrace::shared().clipId(name), bakeEvents);
+    bakeEvents.clear();
+    bakeEvents.shrink_to_fit();
+
+    if (!keepPreSmoothKeys)
+    {
+        std::vector<std::string>().swap(preSmoothBones);
+        std::vector<std::vector<BoneTRS>>().swap(preSmoothKeys);
+    }
+
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Baked clip cache                                              */
+/* -------------------------------------------------------------- */
+bool Animation::loadFromCache(const std::string& filePath, uint64_t cacheKey)
+{
+    BakedClip clip;
+    if (!BakedClipCache::load(filePath, modelRef, cacheKey, clip) || clip.keyframes.empty())
+        return false;
+
+    durationTicks = clip.durationTicks;
+    ticksPerSecond = clip.ticksPerSecond;
+    clipDurationSecs = clip.clipDurationSecs;
+    keyframes = std::move(clip.keyframes);
+    bakeEvents = std::move(clip.jitterEvents);
+    preSmoothBones = std::move(clip.preSmoothBones);
+    preSmoothKeys = std::move(clip.preSmoothKeys);
+
+    // batch smoothing walks these after load
+    animatedBones.clear();
+    for (const auto& [bone, _] : keyframes.front().boneTransforms)
+        animatedBones.push_back(bone);
+    refreshJitterProfiles();
+
+    Logger::log("Loaded clip '" + filePath + "' from cache fps=" +
+        std::to_string(ticksPerSecond), Logger::INFO);
+    return true;
+}
+
+void Animation::saveToCache(const std::string& filePath, uint64_t cacheKey) const
+{
+    if (!BakedClipCache::isEnabled())
+        return;
 
+    BakedClip clip;
+    clip.durationTicks = durationTicks;
+    clip.ticksPerSecond = ticksPerSecond;
+    clip.clipDurationSecs = clipDurationSecs;
+    clip.keyframes = keyframes;
+    clip.jitterEvents = bakeEvents;
+    clip.preSmoothBones = preSmoothBones;
+    clip.preSmoothKeys = preSmoothKeys;
+
+    if (BakedClipCache::save(filePath, modelRef, cacheKey, clip))
+        Logger::log("[CACHE] Wrote " + BakedClipCache::pathFor(filePath, modelRef), Logger::INFO);
 }
 
 
@@ -41,18 +136,21 @@ Animation::Animation(const std::string& filePath,
 /* -------------------------------------------------------------- */
 void Animation::apply(float animationTimeSeconds, Model* model) const
 {
-    if (!loaded || keyframes.empty() || model == nullptr)
+    if (!loaded || keyTimes.empty() || model == nullptr)
     {
         Logger::log("Animation::apply called with invalid state",
             Logger::ERROR);
         return;
     }
 
-    std::map<std::string, glm::mat4> pose;
-    interpolateKeyframes(animationTimeSeconds, pose);
+    FrameArena::Scope scratch(FrameArena::forThisThread());
+    const size_t boneCount = trackCount();
+    glm::mat4* pose = FrameArena::forThisThread().allocateArray<glm::mat4>(boneCount);
+    sampleBoneTracks(animationTimeSeconds, pose);
 
-    for (const auto& pair : pose)
-        model->setBoneTransform(pair.first, pair.second);
+    for (size_t b = 0; b < boneCount; ++b)
+        if (hasTrack(b))
+            model->setBoneTransform(static_cast<int>(b), pose[b]);
 }
 
 
@@ -62,7 +160,7 @@ void Animation::apply(float animationTimeSeconds, Model* model) const
 std::pair<size_t, size_t>
 Animation::findKeyframeIndices(float timeSeconds) const
 {
-    const size_t count = keyframes.size();
+    const size_t count = keyTimes.size();
     if (count == 0)
         return { 0, 0 };
 
@@ -70,47 +168,89 @@ Animation::findKeyframeIndices(float timeSeconds) const
     if (t < 0.0f)
         t += clipDurationSecs;
 
-    for (size_t i = 0; i < count; ++i)
+    // outside [first, last) the pair wraps from the last key to the first
+    if (count < 2 || t < keyTimes.front() || t >= keyTimes.back())
+        return { count - 1, 0 };
+
+    size_t i = findSegment(t, nullptr);
+    return { i, i + 1 };
+}
+
+/* -------------------------------------------------------------- */
+/*  Helper: index i of the segment [keyTimes[i], keyTimes[i+1])   */
+/*  holding t - the first i with t < keyTimes[i+1], clamped to    */
+/*  the last segment. Uniform clips compute it directly, others   */
+/*  resume from the cursor (or binary search without one); the    */
+/*  final walk only corrects float rounding at segment borders.   */
+/* -------------------------------------------------------------- */
+size_t Animation::findSegment(float t, SampleCursor* cursor) const
+{
+    const size_t last = keyTimes.size() - 2;
+
+    size_t i;
+    if (uniformKeys)
     {
-        size_t next = (i + 1) % count;
-        if (t >= keyframes[i].time && t < keyframes[next].time)
-            return { i, next };
+        float f = (t - keyTimes.front()) / keyInterval;
+        i = (f <= 0.0f) ? 0 : std::min(static_cast<size_t>(f), last);
     }
-    return { count - 1, 0 };
+    else if (cursor)
+    {
+        i = std::min(cursor->segment, last);
+    }
+    else
+    {
+        auto it = std::upper_bound(keyTimes.begin() + 1, keyTimes.end(), t);
+        i = std::min(static_cast<size_t>(it - keyTimes.begin()) - 1, last);
+    }
+
+    while (i > 0 && t < keyTimes[i])
+        --i;
+    while (i < last && t >= keyTimes[i + 1])
+        ++i;
+
+    if (cursor)
+        cursor->segment = i;
+    return i;
 }
 
 /* -------------------------------------------------------------- */
-/*  Helper: blend two 4x4 local matrices (SRT decompose)          */
+/*  BoneTRS <-> matrix                                            */
 /* -------------------------------------------------------------- */
-glm::mat4 Animation::interpolateMatrices(const glm::mat4& a,
-    const glm::mat4& b,
-    float            factor) const
+glm::mat4 BoneTRS::toMatrix() const
 {
-    // 1. Decompose both matrices into TRS components
-    glm::vec3 posA, posB, scaleA, scaleB;
-    glm::quat rotA, rotB;
+    glm::mat4 T = glm::translate(glm::mat4(1.0f), translation);
+    glm::mat4 R = glm::mat4_cast(rotation);
+    glm::mat4 S = glm::scale(glm::mat4(1.0f), scale);
+    return T * R * S;
+}
 
+BoneTRS BoneTRS::fromMatrix(const glm::mat4& m)
+{
+    BoneTRS out;
     glm::vec3 skew;
     glm::vec4 perspective;
+    glm::decompose(m, out.scale, out.rotation, out.translation, skew, perspective);
+    out.rotation = glm::normalize(out.rotation);
+    return out;
+}
 
-    glm::decompose(a, scaleA, rotA, posA, skew, perspective);
-    glm::decompose(b, scaleB, rotB, posB, skew, perspective);  // reuse vars
-
+/* -------------------------------------------------------------- */
+/*  Helper: blend two local transforms channel by channel         */
+/* -------------------------------------------------------------- */
+BoneTRS Animation::interpolateTransforms(const BoneTRS& a,
+    const BoneTRS& b,
+    float          factor) const
+{
     // Ensure shortest rotation path
-    if (glm::dot(rotA, rotB) < 0.0f)
+    glm::quat rotB = b.rotation;
+    if (glm::dot(a.rotation, rotB) < 0.0f)
         rotB = -rotB;
 
-    // 2. Interpolate components
-    glm::vec3 posFinal = glm::mix(posA, posB, factor);
-    glm::quat rotFinal = glm::slerp(rotA, rotB, factor);
-    glm::vec3 scaleFinal = glm::mix(scaleA, scaleB, factor);
-
-    // 3. Recompose final matrix
-    glm::mat4 T = glm::translate(glm::mat4(1.0f), posFinal);
-    glm::mat4 R = glm::mat4_cast(rotFinal);
-    glm::mat4 S = glm::scale(glm::mat4(1.0f), scaleFinal);
-
-    return T * R * S;
+    BoneTRS out;
+    out.translation = glm::mix(a.translation, b.translation, factor);
+    out.rotation = glm::slerp(a.rotation, rotB, factor);
+    out.scale = glm::mix(a.scale, b.scale, factor);
+    return out;
 }
 
 
@@ -167,81 +307,846 @@ static glm::vec3 hermite(const glm::vec3& p0, const glm::vec3& m0,
     return h00 * p0 + h10 * m0 + h01 * p1 + h11 * m1;
 }
 
-static glm::mat4 interpolateMatricesCubic(const glm::mat4& prevM,
-    const glm::mat4& a,
-    const glm::mat4& b,
-    const glm::mat4& nextM,
-    float t)
+// Cubic fallback test: does key k1 differ from k2 at all? Rotations are
+// compared after hemisphere alignment.
+static bool keyDiffers(const BoneTRS& k1, const BoneTRS& k2, float epsilon = 1e-6f)
 {
-    // Decompose all four matrices into SRT
-    glm::vec3 sPrev, sA, sB, sNext;
-    glm::vec3 tPrev, tA, tB, tNext;
-    glm::quat rPrev, rA, rB, rNext;
-    glm::vec3 skew; glm::vec4 persp;
-
-    glm::decompose(prevM, sPrev, rPrev, tPrev, skew, persp);
-    glm::decompose(a, sA, rA, tA, skew, persp);
-    glm::decompose(b, sB, rB, tB, skew, persp);
-    glm::decompose(nextM, sNext, rNext, tNext, skew, persp);
-
-    // Align rotations for smooth interpolation
-    hemiAlign(rPrev, rA);
-    hemiAlign(rB, rA);
-    hemiAlign(rNext, rB);
+    glm::quat r1 = k1.rotation;
+    hemiAlign(r1, k2.rotation);
 
+    for (int i = 0; i < 3; ++i)
+    {
+        if (std::abs(k1.translation[i] - k2.translation[i]) > epsilon ||
+            std::abs(k1.scale[i] - k2.scale[i]) > epsilon)
+            return true;
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        if (std::abs(r1[i] - k2.rotation[i]) > epsilon)
+            return true;
+    }
+    return false;
+}
+
+// Squad control point of key q1 between its neighbours, as sampling
+// reads it (normalised twice, like the inline tangents used to be)
+static glm::quat keyControl(const glm::quat& q0, const glm::quat& q1, const glm::quat& q2)
+{
+    return glm::normalize(squadTangent(q0, q1, q2));
+}
+
+// Cubic segment a->b from per-key data: controlA/controlB are the squad
+// control points of a and b, slopeA/slopeB their Hermite slopes. Both
+// are taken on the keys' own hemispheres. havePrev/haveNext: the outer
+// keys are real neighbours rather than repeats of a/b - otherwise the
+// tangents fall back to the a->b segment.
+static BoneTRS interpolateTransformsBaked(const BoneTRS& a,
+    const BoneTRS& b,
+    const glm::quat& controlA,
+    const glm::quat& controlB,
+    const glm::vec3& slopeA,
+    const glm::vec3& slopeB,
+    float t,
+    bool havePrev,
+    bool haveNext)
+{
+    const glm::vec3& tA = a.translation;
+    const glm::vec3& tB = b.translation;
+
+    // Align rotations for smooth interpolation; b's control follows b
+    glm::quat rA = a.rotation;
+    glm::quat rB = b.rotation;
+    glm::quat s1 = controlB;
+    if (glm::dot(rB, rA) < 0.0f) {
+        rB = -rB;
+        s1 = -s1;
+    }
+
+    // === Rotation: SQUAD easing ===
+    glm::quat rotFinal;
+    if (havePrev && haveNext)
+        rotFinal = squad(glm::normalize(rA), controlA, s1, glm::normalize(rB), t);
+    else
+        rotFinal = glm::slerp(glm::normalize(rA), glm::normalize(rB), t);
+
+    // === Translation: Hermite easing ===
+    glm::vec3 mA = havePrev ? slopeA : (tB - tA);
+    glm::vec3 mB = haveNext ? slopeB : (tB - tA);
+    glm::vec3 tFinal = hermite(tA, mA, tB, mB, t);
+
+    // === Scale: linear ===
+    glm::vec3 sFinal = glm::mix(a.scale, b.scale, t);
+
+    return { tFinal, glm::normalize(rotFinal), sFinal };
+}
+
+// Same curve with the per-key data worked out from the four keys
+static BoneTRS interpolateTransformsCubic(const BoneTRS& prevK,
+    const BoneTRS& a,
+    const BoneTRS& b,
+    const BoneTRS& nextK,
+    float t,
+    bool havePrev,
+    bool haveNext)
+{
+    glm::quat controlA = a.rotation;
+    glm::quat controlB = b.rotation;
+    if (havePrev && haveNext) {
+        controlA = keyControl(prevK.rotation, a.rotation, b.rotation);
+        controlB = keyControl(a.rotation, b.rotation, nextK.rotation);
+    }
+
+    return interpolateTransformsBaked(a, b, controlA, controlB,
+        0.5f * (b.translation - prevK.translation),
+        0.5f * (nextK.translation - a.translation),
+        t, havePrev, haveNext);
+}
+
+static BoneTRS interpolateTransformsCubic(const BoneTRS& prevK,
+    const BoneTRS& a,
+    const BoneTRS& b,
+    const BoneTRS& nextK,
+    float t)
+{
     // Detect fallback case (missing neighbors or identical)
-    auto matrixDiffers = [](const glm::mat4& m1, const glm::mat4& m2, float epsilon) -> bool {
-        for (int col = 0; col < 4; ++col)
+    return interpolateTransformsCubic(prevK, a, b, nextK, t,
+        keyDiffers(prevK, a), keyDiffers(nextK, b));
+}
+
+/* -------- SoA lanes for PoseKernels::evaluateCubic ---------------- */
+static void writeQuat(float (&dst)[4][PoseKernels::kMaxLanes], size_t lane, const glm::quat& q)
+{
+    dst[0][lane] = q.w; dst[1][lane] = q.x; dst[2][lane] = q.y; dst[3][lane] = q.z;
+}
+
+static void writeVec3(float (&dst)[3][PoseKernels::kMaxLanes], size_t lane, const glm::vec3& v)
+{
+    dst[0][lane] = v.x; dst[1][lane] = v.y; dst[2][lane] = v.z;
+}
+
+static void writeLane(PoseKernels::CubicLanes& lanes, size_t lane,
+    const BoneTRS& a, const BoneTRS& b,
+    const glm::quat& controlA, const glm::quat& controlB,
+    const glm::vec3& slopeA, const glm::vec3& slopeB,
+    float t, bool havePrev, bool haveNext)
+{
+    writeQuat(lanes.rotA, lane, a.rotation);
+    writeQuat(lanes.rotB, lane, b.rotation);
+    writeQuat(lanes.controlA, lane, controlA);
+    writeQuat(lanes.controlB, lane, controlB);
+    writeVec3(lanes.transA, lane, a.translation);
+    writeVec3(lanes.transB, lane, b.translation);
+    writeVec3(lanes.slopeA, lane, slopeA);
+    writeVec3(lanes.slopeB, lane, slopeB);
+    writeVec3(lanes.scaleA, lane, a.scale);
+    writeVec3(lanes.scaleB, lane, b.scale);
+    lanes.factor[lane] = t;
+    lanes.havePrev[lane] = havePrev ? 1.0f : 0.0f;
+    lanes.haveNext[lane] = haveNext ? 1.0f : 0.0f;
+}
+
+static BoneTRS readLane(const PoseKernels::CubicLanes& lanes, size_t lane)
+{
+    BoneTRS out;
+    out.translation = glm::vec3(lanes.translation[0][lane], lanes.translation[1][lane], lanes.translation[2][lane]);
+    out.rotation = glm::quat(lanes.rotation[0][lane], lanes.rotation[1][lane],
+        lanes.rotation[2][lane], lanes.rotation[3][lane]);
+    out.scale = glm::vec3(lanes.scale[0][lane], lanes.scale[1][lane], lanes.scale[2][lane]);
+    return out;
+}
+
+// Unused lanes repeat lane 0 so the kernel never sees garbage
+static void padLanes(PoseKernels::CubicLanes& lanes, size_t used, size_t width)
+{
+    auto pad = [&](auto& channels) {
+        for (auto& c : channels)
+            for (size_t i = used; i < width; ++i)
+                c[i] = c[0];
+        };
+    pad(lanes.rotA); pad(lanes.rotB); pad(lanes.controlA); pad(lanes.controlB);
+    pad(lanes.transA); pad(lanes.transB); pad(lanes.slopeA); pad(lanes.slopeB);
+    pad(lanes.scaleA); pad(lanes.scaleB);
+    for (size_t i = used; i < width; ++i)
+    {
+        lanes.factor[i] = lanes.factor[0];
+        lanes.havePrev[i] = lanes.havePrev[0];
+        lanes.haveNext[i] = lanes.haveNext[0];
+    }
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Name-keyed pose (adapter over the bone tracks once loaded)    */
+/* -------------------------------------------------------------- */
+void Animation::interpolateKeyframes(float animationTime, std::map<std::string, glm::mat4>& outPose) const
+{
+    // While the clip is still being baked there are no tracks yet
+    if (keyTimes.empty() || boneNames.empty())
+    {
+        std::map<std::string, BoneTRS> pose;
+        interpolateKeyframeMaps(animationTime, pose);
+        for (const auto& [boneName, trs] : pose)
+            outPose[boneName] = trs.toMatrix();
+        return;
+    }
+
+    FrameArena::Scope scratch(FrameArena::forThisThread());
+    const size_t boneCount = trackCount();
+    glm::mat4* local = FrameArena::forThisThread().allocateArray<glm::mat4>(boneCount);
+    sampleBoneTracks(animationTime, local);
+
+    for (size_t b = 0; b < boneCount; ++b)
+        if (hasTrack(b))
+            outPose[boneNames[b]] = local[b];
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Bone-indexed sampling - one contiguous track per bone         */
+/* -------------------------------------------------------------- */
+void Animation::sampleBoneTracks(float animationTime, std::vector<glm::mat4>& outLocal,
+    SampleCursor* cursor) const
+{
+    if (keyTimes.empty()) return;
+
+    if (outLocal.size() < trackCount())
+        outLocal.resize(trackCount(), glm::mat4(1.0f));
+    sampleBoneTracks(animationTime, outLocal.data(), cursor);
+}
+
+void Animation::sampleBoneTracks(float animationTime, glm::mat4* outLocal,
+    SampleCursor* cursor) const
+{
+    const size_t keyCount = keyTimes.size();
+    if (keyCount == 0) return;
+
+    const size_t boneCount = trackCount();
+
+    if (keyCount == 1) {
+        getKeyPose(0, outLocal);
+        return;
+    }
+
+    // === Find key pair for this time (same rule as the keyframe maps) ===
+    const size_t startFrame = findSegment(animationTime, cursor);
+
+    const size_t width = PoseKernels::getLaneWidth();
+    if (width == 1)
+    {
+        for (size_t b = 0; b < boneCount; ++b)
         {
-            for (int row = 0; row < 4; ++row)
-            {
-                if (std::abs(m1[col][row] - m2[col][row]) > epsilon)
-                    return true;
-            }
+            if (!hasTrack(b))
+                continue;
+
+            // the only matrix build per bone
+            outLocal[b] = sampleTrack(b, startFrame, animationTime).toMatrix();
         }
-        return false;
+        return;
+    }
+
+    // SIMD path: bones are gathered into lanes and evaluated `width` at
+    // a time; segment selection is the same as the scalar path
+    PoseKernels::CubicLanes lanes;
+    size_t laneBone[PoseKernels::kMaxLanes];
+    size_t used = 0;
+
+    auto flush = [&]() {
+        padLanes(lanes, used, width);
+        PoseKernels::evaluateCubic(lanes);
+        for (size_t i = 0; i < used; ++i)
+            outLocal[laneBone[i]] = readLane(lanes, i).toMatrix();
+        used = 0;
         };
 
-    bool havePrev = matrixDiffers(prevM, a, 1e-6f);
-    bool haveNext = matrixDiffers(nextM, b, 1e-6f);
+    for (size_t b = 0; b < boneCount; ++b)
+    {
+        if (!hasTrack(b))
+            continue;
 
+        const TrackSegment seg = trackSegment(b, startFrame, animationTime);
+        const BoneTRS keyA = trackKey(b, seg.a);
+        const BoneTRS keyB = trackKey(b, seg.b);
+        glm::quat controlA, controlB;
+        glm::vec3 slopeA, slopeB;
+        trackTangent(b, seg.a, keyA.rotation, controlA, slopeA);
+        trackTangent(b, seg.b, keyB.rotation, controlB, slopeB);
+        writeLane(lanes, used, keyA, keyB, controlA, controlB, slopeA, slopeB, seg.factor,
+            seg.cubic && seg.havePrev, seg.cubic && seg.haveNext);
+        laneBone[used++] = b;
+
+        if (used == width)
+            flush();
+    }
+    if (used > 0)
+        flush();
+}
 
-    // === Rotation: SQUAD easing ===
-    glm::quat rotFinal;
-    if (havePrev && haveNext) {
-        glm::quat s0 = squadTangent(rPrev, rA, rB);
-        glm::quat s1 = squadTangent(rA, rB, rNext);
-        rotFinal = squad(glm::normalize(rA), glm::normalize(s0),
-            glm::normalize(s1), glm::normalize(rB), t);
+/* Key indices of one track's segment around timeSeconds. startFrame is
+   the clip segment holding it; a reduced track uses the last kept key
+   at or before it. Dense and reduced tracks share the cubic rule.      */
+Animation::TrackSegment Animation::trackSegment(size_t bone, size_t startFrame, float timeSeconds) const
+{
+    TrackSegment seg;
+    const size_t count = trackKeyCount(bone);
+    const uint16_t* frames = trackKeyFrames(bone);
+    if (count == 1 || (!frames && count != keyTimes.size()))
+    {
+        // constant track: a == b, evaluates to the key itself
+        seg.a = seg.b = (count == 1) ? 0 : startFrame;
+        return seg;
     }
-    else {
-        glm::quat rBfix = rB;
-        hemiAlign(rBfix, rA);
-        rotFinal = glm::slerp(glm::normalize(rA), glm::normalize(rBfix), t);
+
+    size_t p = startFrame;
+    if (frames)
+    {
+        p = static_cast<size_t>(std::upper_bound(frames, frames + count,
+            static_cast<uint16_t>(startFrame)) - frames);
+        p = std::min(p > 0 ? p - 1 : 0, count - 2);
     }
 
-    // === Translation: Hermite easing ===
-    glm::vec3 mA = 0.5f * (tB - tPrev);
-    glm::vec3 mB = 0.5f * (tNext - tA);
-    if (!havePrev) mA = (tB - tA);
-    if (!haveNext) mB = (tB - tA);
-    glm::vec3 tFinal = hermite(tA, mA, tB, mB, t);
+    float t0 = keyTimes[frames ? frames[p] : p];
+    float t1 = keyTimes[frames ? frames[p + 1] : p + 1];
+    float factor = (t1 > t0) ? (timeSeconds - t0) / (t1 - t0) : 0.0f;
+    seg.factor = glm::clamp(factor, 0.0f, 1.0f);
+
+    seg.a = p;
+    seg.b = p + 1;
+    const size_t prev = (p > 0) ? p - 1 : p;
+    const size_t next = (p + 2 < count) ? p + 2 : p + 1;
+    seg.cubic = (prev != seg.a || next != seg.b);
+
+    // neighbour tests were made on the exact keys when the track was built
+    seg.havePrev = prev != seg.a && trackKeyChanged(bone, seg.a);
+    seg.haveNext = next != seg.b && trackKeyChanged(bone, next);
+    return seg;
+}
 
-    // === Scale: linear ===
-    glm::vec3 sFinal = glm::mix(sA, sB, t);
+BoneTRS Animation::sampleTrack(size_t bone, size_t startFrame, float timeSeconds) const
+{
+    const TrackSegment seg = trackSegment(bone, startFrame, timeSeconds);
+    if (seg.a == seg.b)
+        return trackKey(bone, seg.a);
+    if (!seg.cubic)
+        return interpolateTransforms(trackKey(bone, seg.a), trackKey(bone, seg.b), seg.factor);
+
+    const BoneTRS keyA = trackKey(bone, seg.a);
+    const BoneTRS keyB = trackKey(bone, seg.b);
+    glm::quat controlA, controlB;
+    glm::vec3 slopeA, slopeB;
+    trackTangent(bone, seg.a, keyA.rotation, controlA, slopeA);
+    trackTangent(bone, seg.b, keyB.rotation, controlB, slopeB);
+    return interpolateTransformsBaked(keyA, keyB, controlA, controlB, slopeA, slopeB,
+        seg.factor, seg.havePrev, seg.haveNext);
+}
 
-    // === Recompose final matrix ===
-    glm::mat4 T = glm::translate(glm::mat4(1.0f), tFinal);
-    glm::mat4 R = glm::mat4_cast(glm::normalize(rotFinal));
-    glm::mat4 S = glm::scale(glm::mat4(1.0f), sFinal);
-    return T * R * S;
+// Tangents a track does not store are the ones a constant channel
+// would have: the key's own rotation and a zero slope
+void Animation::trackTangent(size_t bone, size_t key, const glm::quat& keyRotation,
+    glm::quat& control, glm::vec3& slope) const
+{
+    control = keyRotation;
+    slope = glm::vec3(0.0f);
+
+    if (!compressedTracks.empty())
+    {
+        compressedTracks.decodeTangent(bone, key, control, slope);
+        // smallest-three picks its own sign; the curve wants the key's
+        if (glm::dot(control, keyRotation) < 0.0f)
+            control = -control;
+        return;
+    }
+
+    const TrackTangents& tangents = trackTangents[bone];
+    if (!tangents.controls.empty())
+        control = tangents.controls[key];
+    if (!tangents.slopes.empty())
+        slope = tangents.slopes[key];
+}
+
+void Animation::getKeyPose(size_t keyIndex, std::vector<glm::mat4>& outLocal) const
+{
+    if (keyIndex >= keyTimes.size()) return;
+
+    if (outLocal.size() < trackCount())
+        outLocal.resize(trackCount(), glm::mat4(1.0f));
+    getKeyPose(keyIndex, outLocal.data());
+}
+
+void Animation::getKeyPose(size_t keyIndex, glm::mat4* outLocal) const
+{
+    if (keyIndex >= keyTimes.size()) return;
+
+    const size_t boneCount = trackCount();
+    for (size_t b = 0; b < boneCount; ++b)
+        if (hasTrack(b))
+            outLocal[b] = trackKeyAtFrame(b, keyIndex).toMatrix();
+}
+
+BoneTRS Animation::trackKeyAtFrame(size_t bone, size_t frame) const
+{
+    if (trackKeyFrames(bone) || trackKeyCount(bone) != keyTimes.size())
+        return sampleTrack(bone, frame, keyTimes[frame]);
+    return trackKey(bone, frame);
+}
+
+Keyframe Animation::getKeyframe(size_t keyIndex) const
+{
+    // Still baking: the maps are the clip
+    if (keyTimes.empty())
+        return keyframes[keyIndex];
+
+    Keyframe kf;
+    kf.time = keyTimes[keyIndex];
+    for (size_t b = 0; b < trackCount(); ++b)
+        if (hasTrack(b))
+            kf.boneTransforms[boneNames[b]] = trackKeyAtFrame(b, keyIndex);
+    return kf;
+}
+
+std::vector<Keyframe> Animation::getKeyframes() const
+{
+    if (keyTimes.empty())
+        return keyframes;
+
+    std::vector<Keyframe> out;
+    out.reserve(keyTimes.size());
+    for (size_t k = 0; k < keyTimes.size(); ++k)
+        out.push_back(getKeyframe(k));
+    return out;
+}
+
+
+size_t Animation::trackCount() const
+{
+    return compressedTracks.empty() ? boneTracks.size() : compressedTracks.getTrackCount();
+}
+
+bool Animation::hasTrack(size_t bone) const
+{
+    return compressedTracks.empty() ? !boneTracks[bone].empty() : compressedTracks.isAnimated(bone);
+}
+
+bool Animation::trackKeyChanged(size_t bone, size_t key) const
+{
+    return compressedTracks.empty() ? boneTracks[bone].changed[key] != 0 : compressedTracks.keyChanged(bone, key);
+}
+
+BoneTRS Animation::trackKey(size_t bone, size_t key) const
+{
+    if (compressedTracks.empty())
+        return boneTracks[bone].key(key);
+
+    BoneTRS out;
+    compressedTracks.decodeKey(bone, key, out.translation, out.rotation, out.scale);
+    return out;
+}
+
+size_t Animation::trackKeyCount(size_t bone) const
+{
+    return compressedTracks.empty() ? boneTracks[bone].keyCount() : compressedTracks.getKeyCount(bone);
+}
+
+const uint16_t* Animation::trackKeyFrames(size_t bone) const
+{
+    if (!compressedTracks.empty())
+        return compressedTracks.getKeyFrames(bone);
+    const BoneTrack& track = boneTracks[bone];
+    return track.keyFrames.empty() ? nullptr : track.keyFrames.data();
+}
+
+
+/* Resident size of the keyframe maps: the vector, one tree node per
+   bone key (four link/colour words and the pair) and any bone name
+   past the small-string buffer                                     */
+static size_t keyframeBytes(const std::vector<Keyframe>& frames)
+{
+    using Node = std::map<std::string, BoneTRS>::value_type;
+    const size_t inlineName = std::string().capacity();
+
+    size_t bytes = frames.capacity() * sizeof(Keyframe);
+    for (const Keyframe& kf : frames)
+        for (const auto& [bone, _] : kf.boneTransforms)
+            bytes += 4 * sizeof(void*) + sizeof(Node) + (bone.capacity() > inlineName ? bone.capacity() + 1 : 0);
+    return bytes;
+}
+
+/* -------------------------------------------------------------- */
+/*  Pack the keyframe maps into bone-indexed tracks, then drop    */
+/*  the maps: from here on the tracks are the clip                */
+/* -------------------------------------------------------------- */
+void Animation::buildBoneTracks()
+{
+    ++revision;
+    keyTimes.clear();
+    boneTracks.clear();
+    trackTangents.clear();
+    compressedTracks = CompressedClip{};
+    uniformKeys = false;
+    keyInterval = 0.0f;
+
+    if (boneNames.empty() || keyframes.empty())
+        return;
+
+    keyTimes.reserve(keyframes.size());
+    for (const Keyframe& kf : keyframes)
+        keyTimes.push_back(kf.time);
+
+    // Baked clips are evenly spaced; the last gap may be shorter where
+    // the bake clamped to the clip end
+    if (keyTimes.size() > 2)
+    {
+        float step = keyTimes[1] - keyTimes[0];
+        bool uniform = step > 0.0f;
+        for (size_t k = 1; uniform && k + 1 < keyTimes.size(); ++k)
+        {
+            float gap = keyTimes[k + 1] - keyTimes[k];
+            bool lastGap = (k + 2 == keyTimes.size());
+            if (std::fabs(gap - step) > 1e-3f * step && !(lastGap && gap > 0.0f && gap < step))
+                uniform = false;
+        }
+        uniformKeys = uniform;
+        keyInterval = uniform ? step : 0.0f;
+    }
+
+    std::unordered_map<std::string, size_t> boneIndices;
+    for (size_t b = 0; b < boneNames.size(); ++b)
+        boneIndices.emplace(boneNames[b], b);
+
+    boneTracks.resize(boneNames.size());
+    for (const auto& [boneName, firstKey] : keyframes.front().boneTransforms)
+    {
+        auto found = boneIndices.find(boneName);
+        if (found == boneIndices.end())
+            continue;   // clip channel with no skinned bone behind it
+        const size_t boneIndex = found->second;
+
+        BoneTrack& track = boneTracks[boneIndex];
+        track.translations.reserve(keyframes.size());
+        track.rotations.reserve(keyframes.size());
+        track.scales.reserve(keyframes.size());
+        track.changed.reserve(keyframes.size());
+
+        BoneTRS held = firstKey;
+        for (const Keyframe& kf : keyframes)
+        {
+            // every key is filled after load; hold the last value just in case
+            auto it = kf.boneTransforms.find(boneName);
+            if (it != kf.boneTransforms.end())
+                held = it->second;
+
+            track.translations.push_back(held.translation);
+            track.rotations.push_back(held.rotation);
+            track.scales.push_back(held.scale);
+
+            size_t k = track.rotations.size() - 1;
+            track.changed.push_back(k > 0 && keyDiffers(track.key(k - 1), held));
+        }
+    }
+
+    if (compressionSettings.reduceKeys)
+        reduceTracks();
+    if (compressionSettings.enabled)
+    {
+        compressTracks();
+    }
+    else
+    {
+        compressionStats = CompressionStats{};
+        for (const BoneTrack& track : boneTracks)
+            compressionStats.rawBytes += track.sizeInBytes();
+    }
+
+    buildTangents();
+
+    CompressionStats& s = compressionStats;
+    s.tangentBytes = compressedTracks.tangentSizeInBytes();
+    for (const TrackTangents& tangents : trackTangents)
+        s.tangentBytes += tangents.controls.capacity() * sizeof(glm::quat) +
+            tangents.slopes.capacity() * sizeof(glm::vec3);
+    s.keyframeBytes = keyframeBytes(keyframes);
+    s.runtimeBytes = keyTimes.capacity() * sizeof(float) + s.tangentBytes +
+        (compressedTracks.empty() ? s.rawBytes : s.compressedBytes) +
+        boneNames.capacity() * sizeof(std::string) + boneReach.capacity() * sizeof(float);
+    for (const std::string& bone : boneNames)
+        if (bone.capacity() > std::string().capacity())
+            s.runtimeBytes += bone.capacity() + 1;
+    std::vector<Keyframe>().swap(keyframes);
+
+    if (!compressedTracks.empty())
+    {
+        float packedRatio = float(s.rawBytes) / float(std::max<size_t>(s.compressedBytes + s.tangentBytes, 1));
+        Logger::log("[COMPRESS] " + name +
+            " | raw " + std::to_string(s.rawBytes) + " B -> " + std::to_string(s.compressedBytes) + " B" +
+            " + tangents " + std::to_string(s.tangentBytes) + " B" +
+            " (" + std::to_string(packedRatio) + "x)" +
+            " | constant channels " + std::to_string(s.constantChannels) +
+            " | max error " + std::to_string(s.maxWorldError) +
+            " (budget " + std::to_string(compressionSettings.maxWorldError) + ")",
+            Logger::INFO);
+    }
+
+    float ratio = s.runtimeBytes ? float(s.keyframeBytes) / float(s.runtimeBytes) : 0.0f;
+    Logger::log("[MEMORY] " + name +
+        " | keyframes " + std::to_string(s.keyframeBytes) + " B -> runtime " +
+        std::to_string(s.runtimeBytes) + " B (" + std::to_string(ratio) + "x)",
+        Logger::INFO);
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Squad controls and Hermite slopes per key, from the live      */
+/*  (possibly quantised) keys so they match what sampling reads.  */
+/*  Tracks without an interior key never sample cubic and get     */
+/*  none; constant channels need none. A compressed clip packs    */
+/*  them at its own widths.                                       */
+/* -------------------------------------------------------------- */
+void Animation::buildTangents()
+{
+    const size_t boneCount = trackCount();
+    std::vector<TrackTangents> tangentsOf(boneCount);
+
+    ThreadPool::shared().parallelFor(boneCount, [&](size_t b) {
+        const size_t count = hasTrack(b) ? trackKeyCount(b) : 0;
+        if (count < 3)
+            return;
+
+        std::vector<BoneTRS> keys(count);
+        for (size_t k = 0; k < count; ++k)
+            keys[k] = trackKey(b, k);
+
+        bool rotates = false, moves = false;
+        for (size_t k = 1; k < count; ++k)
+        {
+            rotates = rotates || keys[k].rotation != keys[0].rotation;
+            moves = moves || keys[k].translation != keys[0].translation;
+        }
+
+        TrackTangents& tangents = tangentsOf[b];
+        if (rotates)
+        {
+            tangents.controls.resize(count);
+            tangents.controls.front() = keys.front().rotation;
+            tangents.controls.back() = keys.back().rotation;
+            for (size_t k = 1; k + 1 < count; ++k)
+                tangents.controls[k] = keyControl(keys[k - 1].rotation, keys[k].rotation, keys[k + 1].rotation);
+        }
+        if (moves)
+        {
+            tangents.slopes.assign(count, glm::vec3(0.0f));
+            for (size_t k = 1; k + 1 < count; ++k)
+                tangents.slopes[k] = 0.5f * (keys[k + 1].translation - keys[k - 1].translation);
+        }
+        });
+
+    if (compressedTracks.empty())
+    {
+        trackTangents = std::move(tangentsOf);
+        return;
+    }
+    compressedTracks.packTangents(tangentsOf, compressionSettings);
+    trackTangents.clear();
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Reach: distance from a bone to its furthest descendant joint  */
+/*  in the bind pose - how far a rotation error is carried at     */
+/*  the skin                                                      */
+/* -------------------------------------------------------------- */
+std::vector<float> Animation::computeBoneReach(const Model& model) const
+{
+    const std::vector<Bone>& bones = model.getBones();
+
+    std::vector<glm::vec3> bindPos(bones.size());
+    for (size_t i = 0; i < bones.size(); ++i)
+        bindPos[i] = glm::vec3(glm::inverse(bones[i].offsetMatrix)[3]);
+
+    std::vector<float> reach(bones.size(), 0.0f);
+    for (size_t i = 0; i < bones.size(); ++i)
+        for (int a = bones[i].parentIndex; a >= 0; a = bones[a].parentIndex)
+            reach[a] = std::max(reach[a], glm::distance(bindPos[i], bindPos[a]));
+
+    for (float& r : reach)
+        r += compressionSettings.minBoneReach;
+    return reach;
+}
+
+
+// World-space distance between two keys of a bone with the given reach
+static float keyError(const BoneTRS& a, const BoneTRS& b, float reach)
+{
+    // atan2 form: acos(dot) has no float resolution near 1
+    glm::quat d = glm::conjugate(glm::normalize(a.rotation)) * glm::normalize(b.rotation);
+    float angle = 2.0f * std::atan2(glm::length(glm::vec3(d.x, d.y, d.z)), std::fabs(d.w));
+
+    glm::vec3 ds = glm::abs(a.scale - b.scale);
+    return angle * reach + glm::distance(a.translation, b.translation) +
+        std::max(ds.x, std::max(ds.y, ds.z)) * reach;
+}
+
+/* -------------------------------------------------------------- */
+/*  Drop baked keys the cubic/squad path rebuilds within          */
+/*  maxReductionError. Greedy, one pass per bone: a key goes if   */
+/*  every dense frame of the three segments that used it, and the */
+/*  dense curve halfway between frames, still reconstructs within */
+/*  tolerance. Constant tracks keep one key.                      */
+/* -------------------------------------------------------------- */
+void Animation::reduceTracks()
+{
+    const std::vector<float>& reach = boneReach;
+    const float tolerance = compressionSettings.maxReductionError;
+    const int frameCount = static_cast<int>(keyTimes.size());
+
+    // Frame indices are stored as 16 bits - about 18 minutes at 60 fps
+    if (frameCount > 0xFFFF)
+    {
+        Logger::log("[REDUCE] " + name + " too long for sparse tracks, kept dense", Logger::WARNING);
+        return;
+    }
+
+    size_t keysBefore = 0, keysAfter = 0, constantTracks = 0;
+
+    for (size_t b = 0; b < boneTracks.size(); ++b)
+    {
+        BoneTrack& track = boneTracks[b];
+        if (track.empty() || track.keyCount() != keyTimes.size())
+            continue;
+        keysBefore += track.keyCount();
+
+        bool constant = true;
+        for (int k = 1; constant && k < frameCount; ++k)
+            constant = keyError(track.key(0), track.key(k), reach[b]) <= tolerance;
+
+        std::vector<uint16_t> kept;
+        if (constant)
+        {
+            kept.push_back(0);
+            ++constantTracks;
+        }
+        else if (frameCount > 2)
+        {
+            // Dense playback halfway through each frame gap - spikes the
+            // baked keys alone would not show
+            std::vector<BoneTRS> halfway(frameCount - 1);
+            for (int f = 0; f + 1 < frameCount; ++f)
+            {
+                const int pf = f > 0 ? f - 1 : f;
+                const int nf = f + 2 < frameCount ? f + 2 : f + 1;
+                halfway[f] = interpolateTransformsCubic(track.key(pf), track.key(f),
+                    track.key(f + 1), track.key(nf), 0.5f,
+                    pf != f && track.changed[f], nf != f + 1 && track.changed[nf]);
+            }
+
+            std::vector<int> prevK(frameCount), nextK(frameCount);
+            for (int k = 0; k < frameCount; ++k)
+            {
+                prevK[k] = k - 1;
+                nextK[k] = (k + 1 < frameCount) ? k + 1 : -1;
+            }
+
+            // Rebuild the dense frames inside the kept segment starting at a
+            auto segmentHolds = [&](int a) -> bool
+            {
+                // even a one-frame gap counts: its tangents come from the neighbours
+                if (a < 0 || nextK[a] < 0)
+                    return true;
+
+                const int e = nextK[a];
+                const int pk = prevK[a] >= 0 ? prevK[a] : a;
+                const int nk = nextK[e] >= 0 ? nextK[e] : e;
+                const bool cubic = pk != a || nk != e;
+                const bool havePrev = pk != a && keyDiffers(track.key(pk), track.key(a));
+                const bool haveNext = nk != e && keyDiffers(track.key(e), track.key(nk));
+
+                const float ta = keyTimes[a], te = keyTimes[e];
+                auto holds = [&](float time, const BoneTRS& reference)
+                {
+                    float factor = (te > ta) ? (time - ta) / (te - ta) : 0.0f;
+                    factor = glm::clamp(factor, 0.0f, 1.0f);
+
+                    BoneTRS r = cubic
+                        ? interpolateTransformsCubic(track.key(pk), track.key(a),
+                            track.key(e), track.key(nk), factor, havePrev, haveNext)
+                        : interpolateTransforms(track.key(a), track.key(e), factor);
+                    return keyError(r, reference, reach[b]) <= tolerance;
+                };
+
+                for (int f = a; f < e; ++f)
+                {
+                    if (f > a && !holds(keyTimes[f], track.key(f)))
+                        return false;
+                    if (!holds(0.5f * (keyTimes[f] + keyTimes[f + 1]), halfway[f]))
+                        return false;
+                }
+                return true;
+            };
+
+            for (int i = 1; i + 1 < frameCount; ++i)
+            {
+                const int p = prevK[i], q = nextK[i];
+                nextK[p] = q;
+                prevK[q] = p;
+
+                // i was an outer neighbour of the segments either side
+                if (!segmentHolds(prevK[p]) || !segmentHolds(p) || !segmentHolds(q))
+                {
+                    nextK[p] = i;
+                    prevK[q] = i;
+                }
+            }
+
+            for (int k = 0; k >= 0; k = nextK[k])
+                kept.push_back(static_cast<uint16_t>(k));
+        }
+
+        // Every sparse key also carries its frame index; unless a quarter
+        // of the keys go that costs more than it saves once quantised
+        if (kept.empty() || (kept.size() > 1 && kept.size() * 4 > track.keyCount() * 3))
+        {
+            keysAfter += track.keyCount();
+            continue;   // stays dense
+        }
+
+        BoneTrack reduced;
+        reduced.keyFrames = kept;
+        for (size_t j = 0; j < kept.size(); ++j)
+        {
+            BoneTRS key = track.key(kept[j]);
+            reduced.translations.push_back(key.translation);
+            reduced.rotations.push_back(key.rotation);
+            reduced.scales.push_back(key.scale);
+            reduced.changed.push_back(j > 0 && keyDiffers(reduced.key(j - 1), key));
+        }
+        keysAfter += reduced.keyCount();
+        track = std::move(reduced);
+    }
+
+    Logger::log("[REDUCE] " + name +
+        " | keys " + std::to_string(keysBefore) + " -> " + std::to_string(keysAfter) +
+        " | constant tracks " + std::to_string(constantTracks) +
+        " | tolerance " + std::to_string(tolerance),
+        Logger::INFO);
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Quantise the bone tracks against the world-space budget       */
+/* -------------------------------------------------------------- */
+void Animation::compressTracks()
+{
+    compressedTracks = CompressedClip::build(boneTracks, boneReach,
+        compressionSettings, &compressionStats);
+
+    // The quantised copy is now the runtime data; buildBoneTracks
+    // reports the sizes once the tangents are packed too
+    std::vector<BoneTrack>().swap(boneTracks);
 }
 
 
 /* -------------------------------------------------------------- */
 /*  Blend pose - uses union of bones in kfA and kfB               */
 /* -------------------------------------------------------------- */
-void Animation::interpolateKeyframes(float animationTime, std::map<std::string, glm::mat4>& outPose) const
+void Animation::interpolateKeyframeMaps(float animationTime, std::map<std::string, BoneTRS>& outPose) const
 {
     static const std::unordered_set<std::string> wiggleWatchBones = {
         "DEF-hand.L","DEF-hand.R","DEF-forearm.L","DEF-forearm.R",
@@ -255,19 +1160,11 @@ void Animation::interpolateKeyframes(float animationTime, std::map<std::string,
         return;
     }
 
-    // === Find keyframe pair for this time ===
-    size_t startFrame = 0, endFrame = 0;
-    for (size_t i = 0; i < keyframes.size() - 1; ++i) {
-        if (animationTime < keyframes[i + 1].time) {
-            startFrame = i;
-            endFrame = i + 1;
-            break;
-        }
-    }
-    if (endFrame == 0) {
-        startFrame = keyframes.size() - 2;
-        endFrame = keyframes.size() - 1;
-    }
+    // === Find keyframe pair for this time: first i with t < time[i+1] ===
+    auto upper = std::upper_bound(keyframes.begin() + 1, keyframes.end(), animationTime,
+        [](float t, const Keyframe& kf) { return t < kf.time; });
+    size_t startFrame = std::min(static_cast<size_t>(upper - keyframes.begin()) - 1, keyframes.size() - 2);
+    size_t endFrame = startFrame + 1;
 
     const Keyframe& kf0 = keyframes[startFrame];
     const Keyframe& kf1 = keyframes[endFrame];
@@ -284,33 +1181,28 @@ void Animation::interpolateKeyframes(float animationTime, std::map<std::string,
     const Keyframe& kfPrev = keyframes[prevIdx];
     const Keyframe& kfNext = keyframes[nextIdx];
 
-    for (const auto& [boneName, mat0] : kf0.boneTransforms)
+    for (const auto& [boneName, key0] : kf0.boneTransforms)
     {
-        const glm::mat4& a0 = mat0;
-        const glm::mat4& b1 = kf1.boneTransforms.count(boneName) ? kf1.boneTransforms.at(boneName) : a0;
+        const BoneTRS& a0 = key0;
+        const BoneTRS& b1 = kf1.boneTransforms.count(boneName) ? kf1.boneTransforms.at(boneName) : a0;
 
-        const glm::mat4& pPrev = kfPrev.boneTransforms.count(boneName) ? kfPrev.boneTransforms.at(boneName) : a0;
-        const glm::mat4& nNext = kfNext.boneTransforms.count(boneName) ? kfNext.boneTransforms.at(boneName) : b1;
+        const BoneTRS& pPrev = kfPrev.boneTransforms.count(boneName) ? kfPrev.boneTransforms.at(boneName) : a0;
+        const BoneTRS& nNext = kfNext.boneTransforms.count(boneName) ? kfNext.boneTransforms.at(boneName) : b1;
 
         // Determine if cubic easing is safe
         bool canUseCubic = (prevIdx != startFrame || nextIdx != endFrame);
 
-        glm::mat4 interp = canUseCubic
-            ? interpolateMatricesCubic(pPrev, a0, b1, nNext, lerpFactor)
-            : interpolateMatrices(a0, b1, lerpFactor);
-
-        if (wiggleWatchBones.count(boneName)) {
-            glm::vec3 scale, trans;
-            glm::quat rot;
-            glm::vec3 skew; glm::vec4 persp;
-            glm::decompose(interp, scale, rot, trans, skew, persp);
+        BoneTRS interp = canUseCubic
+            ? interpolateTransformsCubic(pPrev, a0, b1, nNext, lerpFactor)
+            : interpolateTransforms(a0, b1, lerpFactor);
 
-            Logger::log("[WIGGLE-CHECK] " + boneName +
+        if (LOG_ENABLED(Logger::DEBUG, Logger::Animation) && wiggleWatchBones.count(boneName)) {
+            Logger::write("[WIGGLE-CHECK] " + boneName +
                 " | Frame " + std::to_string(startFrame) +
                 " -> " + std::to_string(endFrame) +
-                " | Pos: " + glm::to_string(trans) +
-                " | Rot: " + glm::to_string(glm::normalize(rot)),
-                Logger::WARNING);
+                " | Pos: " + glm::to_string(interp.translation) +
+                " | Rot: " + glm::to_string(glm::normalize(interp.rotation)),
+                Logger::DEBUG);
         }
 
         outPose[boneName] = interp;
@@ -336,6 +1228,36 @@ static bool matNearlyEqual(const glm::mat4& a,
     return true;
 }
 
+/* Larger of the steps from curr to its neighbours (distance, degrees) */
+static void measureJitter(const BoneTRS& prev, const BoneTRS& curr, const BoneTRS& next,
+    float& translationStep, float& rotationStepDeg)
+{
+    auto rotationStep = [](const glm::quat& a, glm::quat b) {
+        if (glm::dot(a, b) < 0.0f)
+            b = -b;
+        return glm::degrees(glm::angle(glm::normalize(a) * glm::inverse(glm::normalize(b))));
+        };
+
+    translationStep = std::max(glm::length(curr.translation - prev.translation),
+        glm::length(next.translation - curr.translation));
+    rotationStepDeg = std::max(rotationStep(curr.rotation, prev.rotation),
+        rotationStep(curr.rotation, next.rotation));
+}
+
+/* Trace record for one fix; before/after are curr around the fix */
+static JitterEvent makeJitterEvent(uint16_t clip, uint16_t bone, size_t frame, JitterFix fix,
+    const BoneTRS& prev, const BoneTRS& before, const BoneTRS& after, const BoneTRS& next)
+{
+    JitterEvent e;
+    e.clip = clip;
+    e.bone = bone;
+    e.frame = static_cast<uint32_t>(frame);
+    e.fix = fix;
+    measureJitter(prev, before, next, e.translationBefore, e.rotationBeforeDeg);
+    measureJitter(prev, after, next, e.translationAfter, e.rotationAfterDeg);
+    return e;
+}
+
 /* -------------------------------------------------------------- */
 /*  Animation::loadAnimation                                      */
 /*   parses the FBX clip, auto-detects fps if mTicksPerSecond=0  */
@@ -406,8 +1328,8 @@ void Animation::loadAnimation(const std::string& filePath,
     clipDurationSecs = durationTicks / ticksPerSecond;
 
     /* ----------- gather sparse timeline ----------------------- */
-    std::unordered_map<float,
-        std::map<std::string, glm::mat4>> sparse;
+    std::map<float,
+        std::map<std::string, BoneTRS>> sparse;     /* ordered by time */
 
     for (unsigned int c = 0; c < src->mNumChannels; ++c)
     {
@@ -434,18 +1356,23 @@ void Animation::loadAnimation(const std::string& filePath,
             const aiQuaternion& rot = ch->mRotationKeys[r].mValue;
             const aiVector3D& scl = ch->mScalingKeys[s].mValue;
 
-            glm::mat4 m(1.0f);
-            m = glm::translate(m, { pos.x, pos.y, pos.z });
-            m *= glm::mat4_cast(glm::normalize(glm::quat(rot.w, rot.x, rot.y, rot.z)));
+            BoneTRS key;
+            key.translation = glm::vec3(pos.x, pos.y, pos.z);
+            key.rotation = glm::normalize(glm::quat(rot.w, rot.x, rot.y, rot.z));
+
+            // Exporters emit q and -q freely; keep w >= 0 so the angle
+            // thresholds in the clean-up passes below see one hemisphere
+            if (key.rotation.w < 0.0f)
+                key.rotation = -key.rotation;
 
             glm::vec3 scale(scl.x, scl.y, scl.z);
             if (glm::length(scale - glm::vec3(1.0f)) > 0.01f)
-                m = glm::scale(m, scale);
+                key.scale = scale;
 
             // Optional: discard scaling altogether for rigging safety
-            // m = SkeletonPose::removeScale(m);
+            // key.scale = glm::vec3(1.0f);
 
-            sparse[tSec][bone] = m;
+            sparse[tSec][bone] = key;
         }
     }
 
@@ -461,7 +1388,7 @@ void Animation::loadAnimation(const std::string& filePath,
     }
 
     /* forward-fill --------------------------------------------- */
-    std::map<std::string, glm::mat4> last = keyframes.front().boneTransforms;
+    std::map<std::string, BoneTRS> last = keyframes.front().boneTransforms;
     for (Keyframe& kf : keyframes)
     {
         for (const auto& kv : last)
@@ -471,7 +1398,7 @@ void Animation::loadAnimation(const std::string& filePath,
     }
 
     /* reverse-fill --------------------------------------------- */
-    std::map<std::string, glm::mat4> next = keyframes.back().boneTransforms;
+    std::map<std::string, BoneTRS> next = keyframes.back().boneTransforms;
     for (int i = int(keyframes.size()) - 1; i >= 0; --i)
     {
         for (const auto& kv : next)
@@ -505,23 +1432,27 @@ void Animation::loadAnimation(const std::string& filePath,
     const float ROTATION_JUMP_THRESHOLD = 10.0f;
     const size_t N = keyframes.size();
 
+    JitterTrace& trace = JitterTrace::shared();
+    const uint16_t traceClip = trace.clipId(name);
+
     for (size_t i = 1; i + 1 < N; ++i)
     {
         Keyframe& prev = keyframes[i - 1];
         Keyframe& curr = keyframes[i];
         Keyframe& next = keyframes[i + 1];
 
-        for (const auto& [boneName, prevMat] : prev.boneTransforms)
+        for (const auto& [boneName, prevKey] : prev.boneTransforms)
         {
             if (!curr.boneTransforms.count(boneName) || !next.boneTransforms.count(boneName))
                 continue;
 
-            const glm::mat4& currMat = curr.boneTransforms[boneName];
-            const glm::mat4& nextMat = next.boneTransforms[boneName];
+            const BoneTRS& currKey = curr.boneTransforms[boneName];
+            const BoneTRS& nextKey = next.boneTransforms[boneName];
+            BoneTRS keyBefore = currKey;    // for the trace; currKey follows the fixes
 
-            glm::vec3 prevT(prevMat[3]);
-            glm::vec3 currT(currMat[3]);
-            glm::vec3 nextT(nextMat[3]);
+            glm::vec3 prevT = prevKey.translation;
+            glm::vec3 currT = currKey.translation;
+            glm::vec3 nextT = nextKey.translation;
 
             if ((i >= 26 && i <= 28) || (i >= 57 && i <= 59))
             {
@@ -564,15 +1495,9 @@ void Animation::loadAnimation(const std::string& filePath,
 
             bool shouldClamp = isMiddleSpike || isIsolatedJump || isSmallNoise;
 
-            glm::vec3 scalePrev, scaleCurr, scaleNext;
-            glm::quat rotPrev, rotCurr, rotNext;
-            glm::vec3 transPrev, transCurr, transNext;
-            glm::vec3 skewPrev, skewCurr, skewNext;
-            glm::vec4 perspPrev, perspCurr, perspNext;
-
-            glm::decompose(prevMat, scalePrev, rotPrev, transPrev, skewPrev, perspPrev);
-            glm::decompose(currMat, scaleCurr, rotCurr, transCurr, skewCurr, perspCurr);
-            glm::decompose(nextMat, scaleNext, rotNext, transNext, skewNext, perspNext);
+            glm::vec3 scalePrev = prevKey.scale, scaleCurr = currKey.scale, scaleNext = nextKey.scale;
+            glm::quat rotPrev = prevKey.rotation, rotCurr = currKey.rotation, rotNext = nextKey.rotation;
+            glm::vec3 transPrev = prevT, transCurr = currT, transNext = nextT;
 
             //// Frame 58 forced override
             //if (i == 58 && boneName == "DEF-thigh.L")
@@ -604,7 +1529,9 @@ void Animation::loadAnimation(const std::string& filePath,
             if (glm::dot(rotPrev, rotCurr) < 0.0f && glm::dot(rotNext, rotCurr) < 0.0f)
             {
                 rotCurr = -rotCurr;
-                Logger::log("[HEMISPHERE FIX] Flipped rotCurr at frame " + std::to_string(i) + " for bone " + boneName, Logger::WARNING);
+                LOG_DEBUG(Logger::Animation, "[HEMISPHERE FIX] Flipped rotCurr at frame " + std::to_string(i) + " for bone " + boneName);
+                bakeEvents.push_back(makeJitterEvent(traceClip, trace.boneId(boneName), i, JitterFix::HemisphereFlip,
+                    prevKey, keyBefore, BoneTRS{ transCurr, rotCurr, scaleCurr }, nextKey));
             }
 
             if (glm::dot(rotPrev, rotNext) < 0.0f)
@@ -634,33 +1561,31 @@ void Animation::loadAnimation(const std::string& filePath,
             if (isRotationSpike)
             {
                 glm::quat smoothedR = glm::slerp(rotPrev, rotNext, 0.5f);
-                glm::mat4 rotMat = glm::mat4_cast(smoothedR);
-                glm::mat4 scaleMat = glm::scale(glm::mat4(1.0f), scaleCurr);
-                glm::mat4 transMat = glm::translate(glm::mat4(1.0f), transCurr);
-                curr.boneTransforms[boneName] = transMat * rotMat * scaleMat;
+                curr.boneTransforms[boneName] = { transCurr, smoothedR, scaleCurr };
 
-                Logger::log("[FIXED - ROT SPIKE] Bone '" + boneName +
-                    "' at frame " + std::to_string(i), Logger::WARNING);
+                LOG_DEBUG(Logger::Animation, "[FIXED - ROT SPIKE] Bone '" + boneName +
+                    "' at frame " + std::to_string(i));
+                bakeEvents.push_back(makeJitterEvent(traceClip, trace.boneId(boneName), i, JitterFix::RotSpike,
+                    prevKey, keyBefore, currKey, nextKey));
+                keyBefore = currKey;
             }
 
             // === Generalized translation clamp: suppress jitter across all frames ===
             if (isMiddleSpike || isIsolatedJump || isSmallNoise)
             {
-                Logger::log(
+                LOG_DEBUG(Logger::Animation,
                     "[PRE-BAKE-CLAMP] Bone=" + boneName +
                     " Frame=" + std::to_string(i) +
-                    " (Translation/Rotation spike suppressed in loadAnimation)",
-                    Logger::WARNING
-                );
+                    " (Translation/Rotation spike suppressed in loadAnimation)");
 
                 glm::quat rotSmoothed = glm::normalize(glm::slerp(rotPrev, rotNext, 0.5f));
                 glm::vec3 transSmoothed = (transPrev + transNext) * 0.5f;
-                glm::mat4 smoothedMat = glm::translate(glm::mat4(1.0f), transSmoothed) *
-                    glm::mat4_cast(rotSmoothed) *
-                    glm::scale(glm::mat4(1.0f), scaleCurr);
 
                 // Update the bone transform map instead of assigning to a const ref
-                curr.boneTransforms[boneName] = smoothedMat;
+                curr.boneTransforms[boneName] = { transSmoothed, rotSmoothed, scaleCurr };
+                bakeEvents.push_back(makeJitterEvent(traceClip, trace.boneId(boneName), i, JitterFix::PreBakeClamp,
+                    prevKey, keyBefore, currKey, nextKey));
+                keyBefore = currKey;
             }
 
 
@@ -674,27 +1599,26 @@ void Animation::loadAnimation(const std::string& filePath,
 
                 glm::quat smoothedR = glm::slerp(glm::normalize(rotPrev), glm::normalize(rotNext), 0.5f);
 
-                glm::mat4 scaleMat = glm::scale(glm::mat4(1.0f), smoothedS);
-                glm::mat4 rotMat = glm::mat4_cast(smoothedR);
-                glm::mat4 transMat = glm::translate(glm::mat4(1.0f), smoothedT);
+                curr.boneTransforms[boneName] = { smoothedT, smoothedR, smoothedS };
 
-                curr.boneTransforms[boneName] = transMat * rotMat * scaleMat;
 
 
-
-                Logger::log("[FIXED - SRT+ROT] Bone '" + boneName +
-                    "' at frame " + std::to_string(i), Logger::WARNING);
+                LOG_DEBUG(Logger::Animation, "[FIXED - SRT+ROT] Bone '" + boneName +
+                    "' at frame " + std::to_string(i));
+                bakeEvents.push_back(makeJitterEvent(traceClip, trace.boneId(boneName), i, JitterFix::SrtRot,
+                    prevKey, keyBefore, currKey, nextKey));
             }
         }
     }
 
 
     // Step 1: Bake to dense 60 FPS timeline
-    bakeDenseKeyframes(60.0f);
+    bakeDenseKeyframes(bakeParams.frameRate);
 
     animatedBones.clear();
     for (const auto& [bone, _] : keyframes.front().boneTransforms)
         animatedBones.push_back(bone);
+    refreshJitterProfiles();
 
     suppressPostBakeJitter();
 
@@ -703,34 +1627,30 @@ void Animation::loadAnimation(const std::string& filePath,
 
 
     // === 5-frame smoothing ===
-    if (N < 5)
+    // N counted the source keys; from here on the clip is the dense bake
+    const size_t bakedFrames = keyframes.size();
+    if (bakedFrames < 5)
     {
-        Logger::log("[DRIFT] Skipping smoothing  not enough frames (" + std::to_string(N) + ")", Logger::WARNING);
+        Logger::log("[DRIFT] Skipping smoothing  not enough frames (" + std::to_string(bakedFrames) + ")", Logger::WARNING);
         return;  // exits loadAnimation safely
     }
-    for (size_t i = 2; i + 2 < N; ++i)
+    for (size_t i = 2; i + 2 < bakedFrames; ++i)
     {
         Keyframe& prev2 = keyframes[i - 2];
         Keyframe& curr = keyframes[i];
         Keyframe& next2 = keyframes[i + 2];
 
-        for (const auto& [boneName, matPrev2] : prev2.boneTransforms)
+        for (const auto& [boneName, keyPrev2] : prev2.boneTransforms)
         {
             if (!curr.boneTransforms.count(boneName) || !next2.boneTransforms.count(boneName))
                 continue;
 
-            const glm::mat4& matCurr = curr.boneTransforms[boneName];
-            const glm::mat4& matNext2 = next2.boneTransforms[boneName];
-
-            glm::vec3 scaleA, scaleB, scaleC;
-            glm::quat rotA, rotB, rotC;
-            glm::vec3 transA, transB, transC;
-            glm::vec3 skew, skew2;
-            glm::vec4 persp, persp2;
+            const BoneTRS& keyCurr = curr.boneTransforms[boneName];
+            const BoneTRS& keyNext2 = next2.boneTransforms[boneName];
 
-            glm::decompose(matPrev2, scaleA, rotA, transA, skew, persp);
-            glm::decompose(matCurr, scaleB, rotB, transB, skew, persp);
-            glm::decompose(matNext2, scaleC, rotC, transC, skew2, persp2);
+            glm::quat rotA = keyPrev2.rotation;
+            glm::quat rotB = keyCurr.rotation;
+            glm::quat rotC = keyNext2.rotation;
 
             if (glm::dot(rotA, rotC) < 0.0f)
                 rotC = -rotC;
@@ -744,14 +1664,14 @@ void Animation::loadAnimation(const std::string& filePath,
                 arcAC < 0.5f * ROTATION_JUMP_THRESHOLD)
             {
                 glm::quat smoothed = glm::slerp(rotA, rotC, 0.5f);
-                glm::mat4 T = glm::translate(glm::mat4(1.0f), transB);
-                glm::mat4 R = glm::mat4_cast(smoothed);
-                glm::mat4 S = glm::scale(glm::mat4(1.0f), scaleB);
 
-                curr.boneTransforms[boneName] = T * R * S;
+                const BoneTRS keyBefore = keyCurr;
+                curr.boneTransforms[boneName].rotation = smoothed;
 
-                Logger::log("[FIXED - ROT ARC] Bone " + boneName +
-                    " @frame=" + std::to_string(i), Logger::WARNING);
+                LOG_DEBUG(Logger::Animation, "[FIXED - ROT ARC] Bone " + boneName +
+                    " @frame=" + std::to_string(i));
+                bakeEvents.push_back(makeJitterEvent(traceClip, trace.boneId(boneName), i, JitterFix::RotArc,
+                    keyPrev2, keyBefore, keyCurr, keyNext2));
             }
         }
     }
@@ -811,17 +1731,42 @@ void Animation::loadAnimation(const std::string& filePath,
 
     Logger::log("=== Drift Analysis Pass ===", Logger::WARNING);
 
-    for (const auto& [boneName, _] : keyframes.front().boneTransforms)
+    static const std::unordered_set<std::string> lockCandidates = {
+        "DEF-finger.L", "DEF-finger.R",
+        "DEF-heel.L", "DEF-heel.R"
+    };
+
+    // Each bone is analysed on its own keys only: measure in parallel,
+    // then log and apply the locks in bone order as the serial pass did
+    struct DriftResult
     {
+        bool    analysed = false;
+        bool    allLowVariance = false;
+        size_t  frameCount = 0;
+        bool    lock = false;
+        BoneTRS lockedPose;
+        float   maxStep = 0.0f;         /* largest neighbour step before the lock */
+        float   maxStepDeg = 0.0f;
+    };
+
+    std::vector<std::string> driftNames;
+    for (const auto& [boneName, _] : keyframes.front().boneTransforms)
+        driftNames.push_back(boneName);
+    std::vector<DriftResult> driftResults(driftNames.size());
+
+    ThreadPool::shared().parallelFor(driftNames.size(), [&](size_t b) {
+        const std::string& boneName = driftNames[b];
+        DriftResult& result = driftResults[b];
+
         std::vector<glm::vec3> positions;
         for (const Keyframe& kf : keyframes)
         {
             if (kf.boneTransforms.count(boneName))
-                positions.push_back(glm::vec3(kf.boneTransforms.at(boneName)[3]));
+                positions.push_back(kf.boneTransforms.at(boneName).translation);
         }
 
         if (positions.size() < WINDOW)
-            continue;
+            return;
 
         bool allLowVariance = true;
         for (size_t i = 0; i + WINDOW <= positions.size(); ++i)
@@ -845,21 +1790,12 @@ void Animation::loadAnimation(const std::string& filePath,
             }
         }
 
-        if (allLowVariance)
-        {
-            Logger::log("[DRIFT] Bone: " + boneName + " has consistent low-energy jitter across " +
-                std::to_string(positions.size()) + " frames.", Logger::WARNING);
-        }
-
-        static const std::unordered_set<std::string> lockCandidates = {
-            "DEF-finger.L", "DEF-finger.R",
-            "DEF-heel.L", "DEF-heel.R"
-        };
+        result.analysed = true;
+        result.allLowVariance = allLowVariance;
+        result.frameCount = positions.size();
 
         if (allLowVariance && lockCandidates.count(boneName))
         {
-            Logger::log("[DRIFT] Locking bone '" + boneName + "' to static pose (avg position)", Logger::WARNING);
-
             // Compute average pose
             glm::vec3 avgT(0.0f), avgS(0.0f);
             glm::quat avgR = glm::quat(1, 0, 0, 0);  // identity
@@ -870,10 +1806,9 @@ void Animation::loadAnimation(const std::string& filePath,
                 if (!kf.boneTransforms.count(boneName))
                     continue;
 
-                glm::vec3 t, s, skew;
-                glm::quat r;
-                glm::vec4 persp;
-                glm::decompose(kf.boneTransforms.at(boneName), s, r, t, skew, persp);
+                const BoneTRS& key = kf.boneTransforms.at(boneName);
+                glm::vec3 t = key.translation, s = key.scale;
+                glm::quat r = key.rotation;
 
                 if (count == 0)
                     avgR = r;
@@ -890,16 +1825,57 @@ void Animation::loadAnimation(const std::string& filePath,
             avgT /= float(count);
             avgS /= float(count);
 
-            glm::mat4 T = glm::translate(glm::mat4(1.0f), avgT);
-            glm::mat4 R = glm::mat4_cast(avgR);
-            glm::mat4 S = glm::scale(glm::mat4(1.0f), avgS);
-            glm::mat4 lockedPose = T * R * S;
+            result.lock = true;
+            result.lockedPose = BoneTRS{ avgT, avgR, avgS };
+
+            for (size_t i = 1; i + 1 < keyframes.size(); ++i)
+            {
+                auto prevIt = keyframes[i - 1].boneTransforms.find(boneName);
+                auto currIt = keyframes[i].boneTransforms.find(boneName);
+                auto nextIt = keyframes[i + 1].boneTransforms.find(boneName);
+                if (prevIt == keyframes[i - 1].boneTransforms.end() ||
+                    currIt == keyframes[i].boneTransforms.end() ||
+                    nextIt == keyframes[i + 1].boneTransforms.end())
+                    continue;
+
+                float step, stepDeg;
+                measureJitter(prevIt->second, currIt->second, nextIt->second, step, stepDeg);
+                result.maxStep = std::max(result.maxStep, step);
+                result.maxStepDeg = std::max(result.maxStepDeg, stepDeg);
+            }
+        }
+        });
+
+    for (size_t b = 0; b < driftNames.size(); ++b)
+    {
+        const std::string& boneName = driftNames[b];
+        const DriftResult& result = driftResults[b];
+        if (!result.analysed)
+            continue;
+
+        if (result.allLowVariance)
+        {
+            Logger::log("[DRIFT] Bone: " + boneName + " has consistent low-energy jitter across " +
+                std::to_string(result.frameCount) + " frames.", Logger::WARNING);
+        }
+
+        if (result.lock)
+        {
+            Logger::log("[DRIFT] Locking bone '" + boneName + "' to static pose (avg position)", Logger::WARNING);
 
             // Apply to all frames
             for (Keyframe& kf : keyframes)
-                kf.boneTransforms[boneName] = lockedPose;
+                kf.boneTransforms[boneName] = result.lockedPose;
+
+            // One record for the whole clip, at frame 0
+            JitterEvent lockEvent;
+            lockEvent.clip = traceClip;
+            lockEvent.bone = trace.boneId(boneName);
+            lockEvent.fix = JitterFix::DriftLock;
+            lockEvent.translationBefore = result.maxStep;
+            lockEvent.rotationBeforeDeg = result.maxStepDeg;
+            bakeEvents.push_back(lockEvent);
         }
-
     }
 
     const std::unordered_set<std::string> driftBones = {
@@ -928,34 +1904,57 @@ void Animation::loadAnimation(const std::string& filePath,
 
     Logger::log("[DRIFT] Applying moving average smoothing for known drift bones...", Logger::WARNING);
 
-    const int SMOOTH_RADIUS = 2; // Total window = 5
+    const size_t SMOOTH_RADIUS = 2; // Total window = 5
     std::vector<float> weights = { 0.1f, 0.2f, 0.4f, 0.2f, 0.1f };
 
+    // Bones smooth independently (in place along their own frames); the
+    // log lines are collected per bone and replayed in the serial order
+    std::vector<std::string> smoothBones;
+    std::vector<std::vector<std::pair<std::string, Logger::Level>>> smoothLogs;
     for (const std::string& bone : driftBones)
     {
+        smoothBones.push_back(bone);
+        smoothLogs.emplace_back();
+    }
+
+    ThreadPool::shared().parallelFor(smoothBones.size(), [&](size_t b) {
+        const std::string& bone = smoothBones[b];
+        auto& boneLog = smoothLogs[b];
+
         if (!smoothingWhitelist.count(bone))
         {
-            Logger::log("[DRIFT] Skipping bone (not whitelisted for smoothing): " + bone, Logger::DEBUG);
-            continue;
+            boneLog.emplace_back("[DRIFT] Skipping bone (not whitelisted for smoothing): " + bone, Logger::DEBUG);
+            return;
         }
 
-        Logger::log("[DRIFT] Smoothing bone: " + bone, Logger::WARNING);
+        boneLog.emplace_back("[DRIFT] Smoothing bone: " + bone, Logger::WARNING);
 
-        for (int i = 0; i < N; ++i)
+        // This bone's key in every frame (nullptr where absent)
+        std::vector<BoneTRS*> column(keyframes.size(), nullptr);
+        for (size_t j = 0; j < keyframes.size(); ++j)
+        {
+            auto it = keyframes[j].boneTransforms.find(bone);
+            if (it != keyframes[j].boneTransforms.end())
+                column[j] = &it->second;
+        }
+
+        // Every dense frame; a window hanging off either end is skipped below
+        for (size_t i = 0; i < column.size(); ++i)
         {
             std::vector<glm::vec3> transSamples;
             std::vector<glm::quat> rotSamples;
             std::vector<glm::vec3> scaleSamples;
 
-            for (int j = std::max(0, i - SMOOTH_RADIUS); j <= std::min(int(keyframes.size() - 1), i + SMOOTH_RADIUS); ++j)
+            const size_t first = i >= SMOOTH_RADIUS ? i - SMOOTH_RADIUS : 0;
+            const size_t last = std::min(column.size() - 1, i + SMOOTH_RADIUS);
+            for (size_t j = first; j <= last; ++j)
             {
-                if (!keyframes[j].boneTransforms.count(bone))
+                if (!column[j])
                     continue;
 
-                glm::vec3 t, s, skew;
-                glm::quat r;
-                glm::vec4 persp;
-                glm::decompose(keyframes[j].boneTransforms[bone], s, r, t, skew, persp);
+                const BoneTRS& key = *column[j];
+                glm::vec3 t = key.translation, s = key.scale;
+                glm::quat r = key.rotation;
 
                 if (!rotSamples.empty() && glm::dot(rotSamples.back(), r) < 0.0f)
                     r = -r;
@@ -969,7 +1968,7 @@ void Animation::loadAnimation(const std::string& filePath,
                 rotSamples.size() != weights.size() ||
                 scaleSamples.size() != weights.size())
             {
-                Logger::log("[DRIFT] Skipping smoothing on frame " + std::to_string(i) +
+                boneLog.emplace_back("[DRIFT] Skipping smoothing on frame " + std::to_string(i) +
                     " for bone: " + bone + "  insufficient sample count (" +
                     std::to_string(rotSamples.size()) + " samples)", Logger::WARNING);
                 continue;
@@ -989,13 +1988,14 @@ void Animation::loadAnimation(const std::string& filePath,
                     meanR = glm::normalize(glm::slerp(meanR, rotSamples[k], weights[k]));
             }
 
-            glm::mat4 T = glm::translate(glm::mat4(1.0f), meanT);
-            glm::mat4 R = glm::mat4_cast(meanR);
-            glm::mat4 S = glm::scale(glm::mat4(1.0f), meanS);
-
-            keyframes[i].boneTransforms[bone] = T * R * S;
+            // a full window includes frame i itself, so the key exists
+            *column[i] = { meanT, meanR, meanS };
         }
-    }
+        });
+
+    for (const auto& boneLog : smoothLogs)
+        for (const auto& [message, level] : boneLog)
+            Logger::log(message, level);
 
 
 
@@ -1013,7 +2013,7 @@ void Animation::loadAnimation(const std::string& filePath,
         {
             auto it = lastKF.boneTransforms.find(kv.first);
             if (it == lastKF.boneTransforms.end() ||
-                !matNearlyEqual(kv.second, it->second))
+                !matNearlyEqual(kv.second.toMatrix(), it->second.toMatrix()))
             {
                 samePose = false;
                 break;
@@ -1031,8 +2031,9 @@ void Animation::loadAnimation(const std::string& filePath,
         // Sanitize all keyframes: replace invalid bone matrices with bind pose
         for (Keyframe& kf : keyframes)
         {
-            for (auto& [boneName, mat] : kf.boneTransforms)
+            for (auto& [boneName, key] : kf.boneTransforms)
             {
+                const glm::mat4 mat = key.toMatrix();
                 bool isZero =
                     glm::length(glm::vec4(mat[0])) < 1e-5f &&
                     glm::length(glm::vec4(mat[1])) < 1e-5f &&
@@ -1046,7 +2047,7 @@ void Animation::loadAnimation(const std::string& filePath,
                         ". Using bind pose.", Logger::WARNING);
                     if (modelRef)
                     {
-                        mat = modelRef->getLocalBindPose(boneName);
+                        key = BoneTRS::fromMatrix(modelRef->getLocalBindPose(boneName));
                     }
                     else
                     {
@@ -1065,9 +2066,9 @@ void Animation::loadAnimation(const std::string& filePath,
         Keyframe& first = keyframes.front();
         Keyframe& last = keyframes.back();
 
-        for (const auto& [bone, mat] : first.boneTransforms)
+        for (const auto& [bone, key] : first.boneTransforms)
         {
-            last.boneTransforms[bone] = mat;
+            last.boneTransforms[bone] = key;
         }
 
         Logger::log("[LOOP FIX] Idle final frame matched to first for seamless loop", Logger::WARNING);
@@ -1090,7 +2091,7 @@ void Animation::checkBindMismatch(const Model* model)
     for (const auto& bone : model->getBones())
     {
         glm::mat4 bindLocal = model->getLocalBindPose(bone.name);
-        glm::mat4 firstLocal = getLocalMatrixAtTime(bone.name, 1e-5f);
+        glm::mat4 firstLocal = getLocalMatrixAtTime(*model, bone.name, 1e-5f);
         if (!matNearlyEqual(bindLocal, firstLocal, EPS))
         {
             glm::vec3 bindT(bindLocal[3]);     // extract translation
@@ -1103,24 +2104,29 @@ void Animation::checkBindMismatch(const Model* model)
     mismatchChecked = true;          // <- tiny flag in Animation class
 }
 
-glm::mat4 Animation::getLocalMatrixAtTime(const std::string& bone,
+glm::mat4 Animation::getLocalMatrixAtTime(const Model& model, const std::string& bone,
     float t) const
 {
-    if (keyframes.empty())
+    if (keyTimes.empty())
         return glm::mat4(1.0f);
 
+    // bones the clip leaves alone hold their bind pose
+    const int index = model.getBoneIndex(bone);
+    if (index < 0 || size_t(index) >= trackCount() || !hasTrack(index))
+        return model.getLocalBindPose(bone);
+
     auto idx = findKeyframeIndices(t);
-    const glm::mat4& A = keyframes[idx.first].boneTransforms.at(bone);
-    const glm::mat4& B = keyframes[idx.second].boneTransforms.at(bone);
+    const BoneTRS A = trackKeyAtFrame(index, idx.first);
+    const BoneTRS B = trackKeyAtFrame(index, idx.second);
 
-    float span = keyframes[idx.second].time - keyframes[idx.first].time;
+    float span = keyTimes[idx.second] - keyTimes[idx.first];
     if (span < 0.0f) span += clipDurationSecs;
 
     float factor = (span > 0.0f) ?
-        std::fmod(t - keyframes[idx.first].time + clipDurationSecs,
+        std::fmod(t - keyTimes[idx.first] + clipDurationSecs,
             clipDurationSecs) / span : 0.0f;
 
-    return interpolateMatrices(A, B, factor);
+    return interpolateTransforms(A, B, factor).toMatrix();
 }
 
 void Animation::bakeDenseKeyframes(float targetFPS)
@@ -1162,9 +2168,9 @@ void Animation::bakeDenseKeyframes(float targetFPS)
             currentTime = durationSecs;
 
         // Use your existing interpolateKeyframes logic to get the pose at this exact time
-        std::map<std::string, glm::mat4> bakedPose;
+        std::map<std::string, BoneTRS> bakedPose;
 
-        interpolateKeyframes(currentTime, bakedPose);
+        interpolateKeyframeMaps(currentTime, bakedPose);
 
         Keyframe bakedKF;
         bakedKF.time = currentTime;
@@ -1180,10 +2186,106 @@ void Animation::bakeDenseKeyframes(float targetFPS)
         std::to_string((int)targetFPS) + " FPS", Logger::WARNING);
 }
 
+JitterPassStats suppressBoneJitter(BoneTRS* const* column, size_t N,
+    const JitterProfile& profile, std::vector<JitterEvent>* events,
+    uint16_t traceClip, uint16_t traceBone, std::ostream* log)
+{
+    JitterPassStats stats;
+    const size_t window = profile.window > 0 ? size_t(profile.window) : 0;
+
+    for (size_t i = 1; i + 1 < N; ++i)
+    {
+        BoneTRS& prev = *column[i - 1];
+        BoneTRS& curr = *column[i];
+        BoneTRS& next = *column[i + 1];
+
+        glm::quat rotPrev = prev.rotation, rotCurr = curr.rotation, rotNext = next.rotation;
+        glm::vec3 transPrev = prev.translation, transCurr = curr.translation, transNext = next.translation;
+
+        // Hemisphere alignment for comparison
+        if (glm::dot(rotPrev, rotCurr) < 0.0f) rotCurr = -rotCurr;
+        if (glm::dot(rotNext, rotCurr) < 0.0f) rotNext = -rotNext;
+
+        // Translation deltas
+        glm::vec3 deltaPrev = transCurr - transPrev;
+        glm::vec3 deltaNext = transNext - transCurr;
+        float jump1 = glm::length(deltaPrev);
+        float jump2 = glm::length(deltaNext);
+
+        // Rotation delta in degrees
+        float rotDeltaDeg = glm::degrees(glm::angle(glm::normalize(rotPrev) * glm::inverse(glm::normalize(rotCurr))));
+
+        // === Noise clamp ===
+        if (jump1 < profile.t && jump2 < profile.t && rotDeltaDeg < profile.rDeg)
+        {
+            // Clamp: override curr with prev
+            const BoneTRS before = curr;
+            curr = prev;
+            ++stats.clamped;
+            if (events)
+                events->push_back(makeJitterEvent(traceClip, traceBone, i, JitterFix::PostBakeClamp,
+                    prev, before, curr, next));
+            if (log)
+                *log << "[CLAMPED] frame=" << i << " | Delta T=~" << jump1 << ", Delta R=~" << rotDeltaDeg << "" << std::endl;
+        }
+
+        // === Smoothing window (+-window frames) ===
+        if (window > 0 && i >= window && i + window < N)
+        {
+            BoneTRS m0 = *column[i - window];
+            BoneTRS m1 = *column[i - 1];
+            BoneTRS m3 = *column[i + 1];
+            BoneTRS m4 = *column[i + window];
+
+            BoneTRS smooth = interpolateTransformsCubic(m0, m1, m3, m4, 0.5f); // centered on m2
+            const BoneTRS before = curr;
+            curr = smooth;
+            ++stats.smoothed;
+            if (events)
+                events->push_back(makeJitterEvent(traceClip, traceBone, i, JitterFix::PostBakeSmooth,
+                    prev, before, curr, next));
+            if (log)
+                *log << "[SMOOTHED] frame=" << i << std::endl;
+        }
+    }
+    return stats;
+}
+
 void Animation::suppressPostBakeJitter()
 {
+    if (getKeyframeCount() < 3) return;
+
+    // After load the keys live in the tracks; smooth a decoded copy and
+    // rebuild (buildBoneTracks releases it again)
+    const bool decoded = keyframes.empty();
+    if (decoded)
+        keyframes = getKeyframes();
     const size_t N = keyframes.size();
-    if (N < 3) return;
+
+    // During the bake, keep the targets' unsmoothed keys for the tuner
+    if (keyTimes.empty())
+    {
+        preSmoothBones.clear();
+        preSmoothKeys.clear();
+        for (const std::string& bone : animatedBones)
+        {
+            if (!postBakeTargets.count(bone))
+                continue;
+            std::vector<BoneTRS> keys;
+            keys.reserve(N);
+            for (const Keyframe& kf : keyframes)
+            {
+                auto it = kf.boneTransforms.find(bone);
+                if (it == kf.boneTransforms.end())
+                    break;
+                keys.push_back(it->second);
+            }
+            if (keys.size() != N)
+                continue;       // bone missing from some frames
+            preSmoothBones.push_back(bone);
+            preSmoothKeys.push_back(std::move(keys));
+        }
+    }
 
     // === Sanitize name for log file ===
     std::string sanitizedName = this->name;
@@ -1195,130 +2297,122 @@ void Animation::suppressPostBakeJitter()
 
     // === Open log file ===
     std::ofstream animLog("logs/animations/" + sanitizedName + ".log", std::ios::app);
-    if (!animLog.is_open()) return;
+    if (!animLog.is_open())
+    {
+        if (decoded)
+            std::vector<Keyframe>().swap(keyframes);
+        return;
+    }
 
     animLog << "=== Smoothing pass for " << sanitizedName << " ===" << std::endl;
 
-    // === Target bones: Right leg chain only ===
-    static const std::unordered_set<std::string> rightLegBones = {
-        "DEF-thigh.R", "DEF-shin.R", "DEF-foot.R", "DEF-toe.R"
-    };
+    if (jitterProfiles.size() != animatedBones.size())
+        refreshJitterProfiles();
 
-    // Loop over each bone
-    for (const std::string& boneName : animatedBones)
+    // Resolve each target bone's column up front (same inserts as the
+    // per-frame lookups would make); after that every bone only touches
+    // its own keys, so the bones run in parallel
+    std::vector<std::string> targets;
+    std::vector<JitterProfile> profiles;
+    for (size_t i = 0; i < animatedBones.size(); ++i)
     {
-        if (rightLegBones.count(boneName) == 0)
-            continue; // Skip all non-leg bones
-
-        animLog << ">> Bone: " << boneName << std::endl;
-
-        for (size_t i = 1; i + 1 < N; ++i)
+        if (postBakeTargets.count(animatedBones[i]))
         {
-            glm::mat4& prev = keyframes[i - 1].boneTransforms[boneName];
-            glm::mat4& curr = keyframes[i].boneTransforms[boneName];
-            glm::mat4& next = keyframes[i + 1].boneTransforms[boneName];
-
-            glm::vec3 scalePrev, scaleCurr, scaleNext;
-            glm::quat rotPrev, rotCurr, rotNext;
-            glm::vec3 transPrev, transCurr, transNext;
-            glm::vec3 skew;
-            glm::vec4 persp;
-
-            // Decompose all three
-            glm::decompose(prev, scalePrev, rotPrev, transPrev, skew, persp);
-            glm::decompose(curr, scaleCurr, rotCurr, transCurr, skew, persp);
-            glm::decompose(next, scaleNext, rotNext, transNext, skew, persp);
-
-            // Hemisphere alignment for comparison
-            if (glm::dot(rotPrev, rotCurr) < 0.0f) rotCurr = -rotCurr;
-            if (glm::dot(rotNext, rotCurr) < 0.0f) rotNext = -rotNext;
-
-            // Translation deltas
-            glm::vec3 deltaPrev = transCurr - transPrev;
-            glm::vec3 deltaNext = transNext - transCurr;
-            float jump1 = glm::length(deltaPrev);
-            float jump2 = glm::length(deltaNext);
-
-            // Rotation delta in degrees
-            float rotDeltaDeg = glm::degrees(glm::angle(glm::normalize(rotPrev) * glm::inverse(glm::normalize(rotCurr))));
-
-            // === Noise clamp ===
-            if (jump1 < 0.002f && jump2 < 0.002f && rotDeltaDeg < 0.35f)
-            {
-                // Clamp: override curr with prev
-                keyframes[i].boneTransforms[boneName] = prev;
-                animLog << "[CLAMPED] frame=" << i << " | Delta T=~" << jump1 << ", Delta R=~" << rotDeltaDeg << "" << std::endl;
-            }
-
-            // === Smoothing window (+=2 frame avg) ===
-            if (i >= 2 && i + 2 < N)
-            {
-                glm::mat4 m0 = keyframes[i - 2].boneTransforms[boneName];
-                glm::mat4 m1 = keyframes[i - 1].boneTransforms[boneName];
-                glm::mat4 m2 = keyframes[i].boneTransforms[boneName];
-                glm::mat4 m3 = keyframes[i + 1].boneTransforms[boneName];
-                glm::mat4 m4 = keyframes[i + 2].boneTransforms[boneName];
-
-                glm::mat4 smooth = interpolateMatricesCubic(m0, m1, m3, m4, 0.5f); // centered on m2
-                keyframes[i].boneTransforms[boneName] = smooth;
-                animLog << "[SMOOTHED] frame=" << i << std::endl;
-            }
+            targets.push_back(animatedBones[i]);
+            profiles.push_back(jitterProfiles[i]);
         }
     }
 
-    animLog << "=== Done ===" << std::endl << std::endl;
-}
+    std::vector<std::vector<BoneTRS*>> columns(targets.size(), std::vector<BoneTRS*>(N));
+    for (size_t b = 0; b < targets.size(); ++b)
+        for (size_t i = 0; i < N; ++i)
+            columns[b][i] = &keyframes[i].boneTransforms[targets[b]];
 
+    // Per-bone log text and trace records, written out in bone order afterwards
+    std::vector<std::ostringstream> boneLogs(targets.size());
+    std::vector<std::vector<JitterEvent>> boneEvents(targets.size());
 
+    JitterTrace& trace = JitterTrace::shared();
+    const uint16_t traceClip = trace.clipId(name);
+    std::vector<uint16_t> traceBones(targets.size());
+    for (size_t b = 0; b < targets.size(); ++b)
+        traceBones[b] = trace.boneId(targets[b]);
 
+    ThreadPool::shared().parallelFor(targets.size(), [&](size_t b) {
+        const std::vector<BoneTRS*>& column = columns[b];
+        std::ostringstream& boneLog = boneLogs[b];
 
-static nlohmann::json jitterConfig;
+        boneLog << ">> Bone: " << targets[b] << std::endl;
+        suppressBoneJitter(column.data(), N, profiles[b], &boneEvents[b],
+            traceClip, traceBones[b], &boneLog);
+        });
 
-static void loadJitterConfig()
-{
-    if (!jitterConfig.is_null()) return; // Already loaded
+    for (const std::ostringstream& boneLog : boneLogs)
+        animLog << boneLog.str();
 
-    std::ifstream f("jitter_config.json");
-    if (f)
+    // During the bake the events travel with the clip (and its cache
+    // entry); a later batch pass goes straight into the trace
+    for (const std::vector<JitterEvent>& events : boneEvents)
     {
-        f >> jitterConfig;
-    }
-    else
-    {
-        Logger::log("WARNING: jitter_config.json not found. Using defaults.", Logger::WARNING);
-        jitterConfig = nlohmann::json::object();  // empty fallback
+        if (keyTimes.empty())
+            bakeEvents.insert(bakeEvents.end(), events.begin(), events.end());
+        else
+            trace.record(events);
     }
+
+    animLog << "=== Done ===" << std::endl << std::endl;
+
+    // Re-run after load (batch smoothing) - keep the runtime tracks in sync
+    if (!keyTimes.empty())
+        buildBoneTracks();
 }
 
-JitterProfile Animation::getProfileFor(const std::string& animName, const std::string& boneName) const
-{
-    loadJitterConfig();
-
-    auto resolve = [&](const std::string& a, const std::string& b) -> std::optional<JitterProfile> {
-        if (!jitterConfig.contains(a)) return std::nullopt;
-        auto& animBlock = jitterConfig[a];
-        if (!animBlock.contains(b)) return std::nullopt;
-        auto entry = animBlock[b];
-        return JitterProfile{
-            entry.value("t", 0.002f),
-            entry.value("rDeg", 0.35f),
-            entry.value("window", 2)
-        };
-        };
 
-    // Try exact match
-    if (auto p = resolve(animName, boneName)) return *p;
 
-    // Try anim + "*"
-    if (auto p = resolve(animName, "*")) return *p;
 
-    // Try "* + bone"
-    if (auto p = resolve("*", boneName)) return *p;
+bool Animation::rebake(const Model& model)
+{
+    Animation fresh(name, &model, compressionSettings, !preSmoothBones.empty());
+    if (!fresh.isLoaded())
+    {
+        Logger::log("[JITTER] Rebake of " + name + " failed, keeping the current clip", Logger::WARNING);
+        return false;
+    }
 
-    // Fallback global default
-    if (auto p = resolve("*", "*")) return *p;
+    // Revision stays monotonic so palettes baked from the old keys go stale
+    const uint32_t previous = revision;
+    *this = std::move(fresh);
+    revision = previous + 1;
+    return true;
+}
 
-    return { 0.002f, 0.35f, 2 }; // default if nothing matches
+bool Animation::isPostBakeTarget(const std::string& boneName)
+{
+    return postBakeTargets.count(boneName) != 0;
+}
+
+JitterProfile Animation::getProfileFor(const std::string& animName, const std::string& boneName) const
+{
+    return JitterConfig::shared().resolve(animName, boneName);
+}
+
+bool Animation::refreshJitterProfiles()
+{
+    // One table snapshot for the whole clip, so a concurrent reload
+    // cannot leave it half old, half new
+    const std::shared_ptr<const JitterConfig::Table> table = JitterConfig::shared().getTable();
+    const std::string clip = JitterConfig::clipKey(name);
+
+    std::vector<JitterProfile> resolved(animatedBones.size());
+    bool changed = jitterProfiles.size() != resolved.size();
+    for (size_t i = 0; i < animatedBones.size(); ++i)
+    {
+        resolved[i] = JitterConfig::resolve(*table, clip, animatedBones[i]);
+        if (!changed && resolved[i] != jitterProfiles[i] && postBakeTargets.count(animatedBones[i]))
+            changed = true;
+    }
+    jitterProfiles = std::move(resolved);
+    return changed;
 }
 
 
@@ -1338,55 +2432,3 @@ bool detectRotationalWobbleBand(const glm::quat& q0, const glm::quat& q1, const
     return changedDirection && isConfined && hasEnoughRotation;
 }
 
-
-void Animation::dumpEnginePoseAllFramesJSON(const std::string& outputPath) const
-{
-    if (!loaded || keyframes.empty())
-    {
-        Logger::log("dumpEnginePoseAllFramesJSON: animation not loaded", Logger::ERROR);
-        return;
-    }
-
-    nlohmann::json root;
-
-    for (size_t i = 0; i < keyframes.size(); ++i)
-    {
-        const Keyframe& kf = keyframes[i];
-        nlohmann::json bonesJson;
-
-        for (const auto& [boneName, mat] : kf.boneTransforms)
-        {
-            nlohmann::json matJson = nlohmann::json::array();
-            for (int row = 0; row < 4; ++row)
-            {
-                nlohmann::json rowJson = nlohmann::json::array();
-                for (int col = 0; col < 4; ++col)
-                {
-                    rowJson.push_back(mat[col][row]);  // column-major to row-major
-                }
-                matJson.push_back(rowJson);
-            }
-            bonesJson[boneName] = matJson;
-        }
-
-        root[std::to_string(i)] = bonesJson;
-    }
-
-    std::string sanitized = this->name;
-    std::replace(sanitized.begin(), sanitized.end(), '/', '_');
-    std::replace(sanitized.begin(), sanitized.end(), '\\', '_');
-
-    std::filesystem::create_directories("logs");
-    std::ofstream outFile("logs/pose_dump_" + sanitized + ".json");
-    if (!outFile.is_open())
-    {
-        Logger::log("ERROR: Could not open output file for pose dump", Logger::ERROR);
-        return;
-    }
-
-    outFile << root.dump(2);  // pretty print
-    outFile.close();
-
-    Logger::log("Pose dump (JSON) complete for animation: " + this->name, Logger::INFO);
-}
-
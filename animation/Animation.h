@@ -1,6 +1,7 @@
 #ifndef ANIMATION_H
 #define ANIMATION_H
 
+#include <iosfwd>
 #include <string>
 #include <vector>
 #include <map>
@@ -8,37 +9,116 @@
 #include <unordered_set>
 #include <utility>
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "AnimationCompression.h"
+#include "BakedClipCache.h"
+#include "JitterConfig.h"
 
 class Model;
 
+/* Local bone transform kept as separate channels, straight from the
+   aiNodeAnim keys. Blending works on the channels; the matrix is only
+   built once the final pose is known.                                  */
+struct BoneTRS
+{
+    glm::vec3 translation{ 0.0f };
+    glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 scale{ 1.0f };
+
+    glm::mat4 toMatrix() const;                          /* T * R * S */
+    static BoneTRS fromMatrix(const glm::mat4& m);
+};
+
 /* Each keyframe is stored in SECONDS, not ticks */
 struct Keyframe
 {
     float time;                                          /* seconds */
-    std::map<std::string, glm::mat4> boneTransforms;     /* local */
+    std::map<std::string, BoneTRS> boneTransforms;       /* local */
+};
+
+/* Runtime clip storage: one contiguous track per model bone, indexed by
+   Model::getBoneIndex. Key k sits at keyTimes[keyFrames[k]]; a track
+   with no keyFrames has one key per baked frame. After key reduction a
+   constant track holds a single key. Bones the clip does not animate
+   have an empty track.                                                 */
+struct BoneTrack
+{
+    std::vector<glm::vec3> translations;                 /* one per key */
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<uint8_t>   changed;    /* key k differs from key k-1 (cubic fallback test) */
+    std::vector<uint16_t>  keyFrames;  /* baked frame index per key, ascending */
+
+    bool    empty() const { return rotations.empty(); }
+    size_t  keyCount() const { return rotations.size(); }
+    BoneTRS key(size_t k) const { return { translations[k], rotations[k], scales[k] }; }
+    size_t  sizeInBytes() const
+    {
+        return translations.capacity() * sizeof(glm::vec3) + rotations.capacity() * sizeof(glm::quat) +
+            scales.capacity() * sizeof(glm::vec3) + changed.capacity() + keyFrames.capacity() * sizeof(uint16_t);
+    }
 };
 
-struct JitterProfile {
-    float t;
-    float rDeg;
-    int window;
+/* Cubic data baked per key of a runtime track, so sampling a segment
+   never looks past its two keys: the squad control point of each
+   interior key and its central-difference Hermite slope. End keys hold
+   their own rotation and a zero slope; BoneTrack::changed keeps the
+   sampler from reading them. Tracks with no interior key carry none,
+   and a constant channel leaves its vector empty (the key's rotation,
+   a zero slope). Compressed clips quantise this into the clip.        */
+struct TrackTangents
+{
+    std::vector<glm::quat> controls;                     /* one per key, or none */
+    std::vector<glm::vec3> slopes;
+};
+
+/* Playback-side search state for clips whose keys are not evenly
+   spaced: sampling resumes the segment search where the last one
+   ended, so consecutive samples cost O(1) whatever the clip length. */
+struct SampleCursor
+{
+    size_t segment = 0;
 };
 
 bool detectRotationalWobbleBand(const glm::quat& q0, const glm::quat& q1, const glm::quat& q2, float thresholdDeg);
 
+/* Post-bake clean-up of one bone's baked keys (column[frame]), in
+   place: a frame whose steps to both neighbours stay under profile.t
+   and profile.rDeg is clamped to the previous key, then each frame at
+   least profile.window from the ends is refit by a cubic through the
+   keys window frames away and the adjacent ones. Used by
+   Animation::suppressPostBakeJitter and by JitterTuner's sweep.       */
+struct JitterPassStats
+{
+    size_t clamped = 0;
+    size_t smoothed = 0;
+};
+
+JitterPassStats suppressBoneJitter(BoneTRS* const* column, size_t frameCount,
+    const JitterProfile& profile,
+    std::vector<JitterEvent>* events = nullptr,
+    uint16_t traceClip = 0, uint16_t traceBone = 0,
+    std::ostream* log = nullptr);
+
 
 class Animation
 {
     bool loaded = false;
 
 public:
+    /* keepPreSmoothKeys: hold on to getPreSmoothKeys after loading
+       (tools only; clips for playback release them)               */
     explicit Animation(const std::string& filePath,
-        const Model* model);
+        const Model* model,
+        const CompressionSettings& compression = CompressionSettings{},
+        bool keepPreSmoothKeys = false);
 
     /* status ---------------------------------------------------- */
     bool  isLoaded() const { return loaded; }
     bool  bindMismatchChecked() const { return mismatchChecked; }
-    glm::mat4 getLocalMatrixAtTime(const std::string& bone,
+    /* bone indices and bind poses come from model, which must have the
+       skeleton the clip was built for                               */
+    glm::mat4 getLocalMatrixAtTime(const Model& model, const std::string& bone,
         float seconds) const;
     /* timeline meta --------------------------------------------- */
     float getTicksPerSecond()   const { return ticksPerSecond; }
@@ -50,38 +130,154 @@ public:
     void  interpolateKeyframes(float animationTimeSeconds,
         std::map<std::string, glm::mat4>& outPose) const;
 
+    /* bone-indexed sampling: writes the local matrix of every animated
+       bone into outLocal[boneIndex]; other entries are left untouched.
+       The pointer forms expect getTrackCount() entries; the vector
+       forms grow outLocal to that size first.                          */
+    void  sampleBoneTracks(float animationTimeSeconds,
+        std::vector<glm::mat4>& outLocal,
+        SampleCursor* cursor = nullptr) const;
+    void  sampleBoneTracks(float animationTimeSeconds,
+        glm::mat4* outLocal,
+        SampleCursor* cursor = nullptr) const;
+    void  getKeyPose(size_t keyIndex,
+        std::vector<glm::mat4>& outLocal) const;
+    void  getKeyPose(size_t keyIndex,
+        glm::mat4* outLocal) const;
+    size_t getTrackCount() const { return trackCount(); }
+
+    /* bumped whenever the runtime tracks are rebuilt (load, batch
+       smoothing); anything derived from the sampled poses compares it */
+    uint32_t getRevision() const { return revision; }
+
     /* debug helpers --------------------------------------------- */
-    size_t          getKeyframeCount() const { return keyframes.size(); }
+    size_t          getKeyframeCount() const { return keyTimes.empty() ? keyframes.size() : keyTimes.size(); }
+    float           getKeyTime(size_t keyIndex) const { return keyTimes.empty() ? keyframes[keyIndex].time : keyTimes[keyIndex]; }
+    bool            isUniformlySampled() const { return uniformKeys; }
     const std::string& getName() const { return name; }
+    const std::vector<std::string>& getAnimatedBones() const { return animatedBones; }
     bool  mismatchChecked = false;
     void checkBindMismatch(const Model* model);
-    const std::vector<Keyframe>& getKeyframes() const { return keyframes; }
+
+    /* baked keys in map form, decoded from the runtime tracks (the maps
+       themselves are released once the tracks are built). Bones the
+       model does not skin are left out. Each call builds the maps, so
+       keep these to tools and one-off dumps.                          */
+    Keyframe getKeyframe(size_t keyIndex) const;
+    std::vector<Keyframe> getKeyframes() const;
+    bool  isCompressed() const { return !compressedTracks.empty(); }
+    const CompressionStats& getCompressionStats() const { return compressionStats; }
 
     JitterProfile getProfileFor(const std::string& animName, const std::string& boneName) const;
+    const std::vector<JitterProfile>& getJitterProfiles() const { return jitterProfiles; }
+    /* re-resolves against the current JitterConfig table; true if a bone
+       the post-bake pass smooths now has a different profile          */
+    bool refreshJitterProfiles();
     void suppressPostBakeJitter();
-    void dumpEnginePoseAllFramesJSON(const std::string& outputPath) const;
+
+    /* rebuilds the clip from its FBX with the current profiles (the
+       cache misses once they differ) and bumps the revision; the
+       current clip is kept if the import fails. Not while it plays.
+       model is the caller's, with the skeleton the clip was built for. */
+    bool rebake(const Model& model);
+
+    /* bones suppressPostBakeJitter smooths */
+    static bool isPostBakeTarget(const std::string& boneName);
+
+    /* the post-bake targets' baked keys as that pass received them,
+       one per baked frame; empty unless the clip was built with
+       keepPreSmoothKeys. JitterTuner scores its candidates on these. */
+    const std::vector<std::string>& getPreSmoothBones() const { return preSmoothBones; }
+    const std::vector<std::vector<BoneTRS>>& getPreSmoothKeys() const { return preSmoothKeys; }
 
 
 private:
     /* helpers --------------------------------------------------- */
     void  loadAnimation(const std::string& filePath, const Model* model);
-    glm::mat4 interpolateMatrices(const glm::mat4& a,
-        const glm::mat4& b,
-        float            factor) const;
+    bool  loadFromCache(const std::string& filePath, uint64_t cacheKey);
+    void  saveToCache(const std::string& filePath, uint64_t cacheKey) const;
+    BoneTRS interpolateTransforms(const BoneTRS& a,
+        const BoneTRS& b,
+        float          factor) const;
     std::pair<size_t, size_t>
         findKeyframeIndices(float timeSeconds) const;
+    size_t findSegment(float timeSeconds, SampleCursor* cursor) const;
+    void  interpolateKeyframeMaps(float animationTimeSeconds,
+        std::map<std::string, BoneTRS>& outPose) const;
+    void  buildBoneTracks();
+    void  reduceTracks();
+    void  compressTracks();
+    void  buildTangents();
+    std::vector<float> computeBoneReach(const Model& model) const;
+
+    /* track access - raw or quantised, whichever is live */
+    size_t  trackCount() const;
+    bool    hasTrack(size_t bone) const;
+    bool    trackKeyChanged(size_t bone, size_t key) const;
+    BoneTRS trackKey(size_t bone, size_t key) const;
+    size_t  trackKeyCount(size_t bone) const;
+    const uint16_t* trackKeyFrames(size_t bone) const;   /* nullptr: every frame */
+    BoneTRS sampleTrack(size_t bone, size_t startFrame, float timeSeconds) const;
+    BoneTRS trackKeyAtFrame(size_t bone, size_t frame) const;  /* rebuilt where the track dropped it */
+    void    trackTangent(size_t bone, size_t key, const glm::quat& keyRotation,
+        glm::quat& control, glm::vec3& slope) const;
+
+    /* key indices (into the track) bracketing one sample */
+    struct TrackSegment
+    {
+        size_t a = 0, b = 0;
+        float  factor = 0.0f;
+        bool   cubic = false;       /* false: slerp/mix between a and b */
+        bool   havePrev = false;
+        bool   haveNext = false;
+    };
+    TrackSegment trackSegment(size_t bone, size_t startFrame, float timeSeconds) const;
 
     /* data ------------------------------------------------------ */
+    BakeParams bakeParams;
     float durationTicks = 0.0f;
     float ticksPerSecond = 24.0f;
     float clipDurationSecs = 0.0f;
 
+    /* baked keys while loading; released by buildBoneTracks */
     std::vector<Keyframe> keyframes;
     std::string           name;
 
+    /* bone-indexed runtime tracks, rebuilt from keyframes after loading */
+    std::vector<float>     keyTimes;
+    std::vector<BoneTrack> boneTracks;
+    bool  uniformKeys = false;          /* keyTimes[k] ~= keyTimes[0] + k * keyInterval */
+    uint32_t revision = 0;
+    float keyInterval = 0.0f;
+
+    /* per-key cubic data of the float tracks, bone-indexed; empty once
+       compressed (the quantised tangents live in compressedTracks)  */
+    std::vector<TrackTangents> trackTangents;
+
+    /* quantised copy of boneTracks; the raw tracks are released once built */
+    CompressionSettings compressionSettings;
+    CompressedClip      compressedTracks;
+    CompressionStats    compressionStats;
+
     /* optional bookkeeping ------------------------------------- */
     std::vector<std::string> animatedBones;
-    const Model* modelRef = nullptr;
+    const Model* modelRef = nullptr;    /* only while the constructor runs */
+
+    /* the skeleton the clip was built for, by bone index: tracks are
+       rebuilt after load and the clip outlives the model it loaded on */
+    std::vector<std::string> boneNames;
+    std::vector<float> boneReach;
+
+    /* jitter_config.json resolved for this clip, parallel to animatedBones */
+    std::vector<JitterProfile> jitterProfiles;
+
+    /* corrections made by the bake passes, cached with the keys and
+       handed to JitterTrace::shared() once the clip is built */
+    std::vector<JitterEvent> bakeEvents;
+
+    /* captured by the bake's post-bake pass, parallel; cached with the keys */
+    std::vector<std::string>          preSmoothBones;
+    std::vector<std::vector<BoneTRS>> preSmoothKeys;
     void bakeDenseKeyframes(float targetFPS);
 
 
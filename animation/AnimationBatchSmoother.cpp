@@ -1,6 +1,11 @@
 // AnimationBatchSmoother.cpp
 #include "Animation.h"
+#include "JitterConfig.h"
+#include "JitterTrace.h"
+#include "PoseDump.h"
 #include "../common_utils/Logger.h"
+#include "../common_utils/ThreadPool.h"
+#include <algorithm>
 #include <vector>
 #include <string>
 
@@ -8,6 +13,9 @@ void RunBatchSmoothing(const std::vector<Animation*>& animations)
 {
     Logger::log("=== Batch Smoothing: Starting ===", Logger::WARNING);
 
+    // Each clip is smoothed on its own data, so whole clips run in
+    // parallel; a clip listed twice is smoothed once per listing, in turn
+    std::vector<Animation*> clips;
     for (Animation* anim : animations)
     {
         if (!anim || !anim->isLoaded())
@@ -17,10 +25,64 @@ void RunBatchSmoothing(const std::vector<Animation*>& animations)
         }
 
         Logger::log("[RUNNING] Smoothing " + anim->getName(), Logger::WARNING);
-        anim->suppressPostBakeJitter();
-        Logger::log("[DONE] Smoothing " + anim->getName(), Logger::WARNING);
+        clips.push_back(anim);
     }
 
+    // A queued pose dump may still be reading the keys
+    PoseDump::wait();
+
+    // Group repeats of the same clip so one task runs them back to back
+    std::vector<Animation*> unique = clips;
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+    ThreadPool::shared().parallelFor(unique.size(), [&](size_t i) {
+        const size_t passes = std::count(clips.begin(), clips.end(), unique[i]);
+        for (size_t p = 0; p < passes; ++p)
+            unique[i]->suppressPostBakeJitter();
+        });
+
+    for (Animation* anim : clips)
+        Logger::log("[DONE] Smoothing " + anim->getName(), Logger::WARNING);
+
+    JitterTrace::shared().saveAsync();
+
     Logger::log("=== Batch Smoothing: Complete ===", Logger::WARNING);
 
 }
+
+size_t ReloadJitterConfig(const std::vector<Animation*>& animations, const Model& model)
+{
+    if (!JitterConfig::shared().reload())
+        return 0;
+
+    std::vector<Animation*> changed;
+    for (Animation* anim : animations)
+    {
+        if (anim && anim->isLoaded() && anim->refreshJitterProfiles())
+            changed.push_back(anim);
+    }
+
+    Logger::log("[JITTER] " + std::to_string(changed.size()) + " of " +
+        std::to_string(animations.size()) + " clip(s) affected by the new profiles", Logger::INFO);
+
+    if (changed.empty())
+        return 0;
+
+    // The built keys have been through the post-bake pass and the passes
+    // after it, so re-running it would smooth smoothed keys: rebake the
+    // affected clips from their FBX instead
+    PoseDump::wait();
+
+    std::vector<uint8_t> rebaked(changed.size(), 0);
+    ThreadPool::shared().parallelFor(changed.size(), [&](size_t i) {
+        rebaked[i] = changed[i]->rebake(model) ? 1 : 0;
+        });
+
+    for (size_t i = 0; i < changed.size(); ++i)
+        if (rebaked[i])
+            Logger::log("[JITTER] Rebaked " + changed[i]->getName(), Logger::INFO);
+
+    JitterTrace::shared().saveAsync();
+    return changed.size();
+}
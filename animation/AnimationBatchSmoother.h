@@ -1,8 +1,15 @@
 // AnimationBatchSmoother.h
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
 class Animation;
+class Model;
 
 void RunBatchSmoothing(const std::vector<Animation*>& animations);
+
+// Re-reads jitter_config.json if it changed on disk and rebakes only
+// the clips whose post-bake profiles differ, against model (the
+// caller's, with the clips' skeleton). Returns how many were.
+size_t ReloadJitterConfig(const std::vector<Animation*>& animations, const Model& model);
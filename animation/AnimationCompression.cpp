@@ -0,0 +1,420 @@
+// AnimationCompression.cpp
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include "AnimationCompression.h"
+#include "Animation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    // Once the largest component is dropped the other three of a unit
+    // quaternion lie in [-1/sqrt(2), 1/sqrt(2)]
+    constexpr float   kSmallestThreeRange = 0.70710678f;
+    constexpr uint8_t kMinRotationBits = 4;
+    constexpr uint8_t kMaxBits = 16;
+
+    uint32_t quantize(float v, float minV, float extent, uint8_t bits)
+    {
+        const uint32_t maxQ = (1u << bits) - 1u;
+        float n = (extent > 0.0f) ? (v - minV) / extent : 0.0f;
+        n = std::min(std::max(n, 0.0f), 1.0f);
+        return static_cast<uint32_t>(n * float(maxQ) + 0.5f);
+    }
+
+    float dequantize(uint32_t q, float minV, float extent, uint8_t bits)
+    {
+        const uint32_t maxQ = (1u << bits) - 1u;
+        return minV + extent * (float(q) / float(maxQ));
+    }
+
+    void writeBits(std::vector<uint8_t>& stream, size_t bitPos, uint8_t bits, uint32_t value)
+    {
+        for (uint8_t i = 0; i < bits; ++i)
+            if ((value >> i) & 1u)
+                stream[(bitPos + i) >> 3] |= uint8_t(1u << ((bitPos + i) & 7));
+    }
+
+    // LSB-first stream; one unaligned 8-byte load covers any field up to
+    // 32 bits wherever it starts (little-endian targets only)
+    inline uint32_t readBits(const uint8_t* stream, size_t bitPos, uint8_t bits)
+    {
+        uint64_t word;
+        std::memcpy(&word, stream + (bitPos >> 3), sizeof(word));
+        return static_cast<uint32_t>((word >> (bitPos & 7)) & ((1ull << bits) - 1ull));
+    }
+
+    /* -------- smallest-three quaternions -------------------------- */
+    void encodeQuat(const glm::quat& in, uint8_t bits, uint32_t& largest, uint32_t packed[3])
+    {
+        glm::quat q = glm::normalize(in);
+
+        largest = 0;
+        for (int i = 1; i < 4; ++i)
+            if (std::fabs(q[i]) > std::fabs(q[largest]))
+                largest = static_cast<uint32_t>(i);
+
+        // q and -q are the same rotation; keep the dropped component positive
+        if (q[largest] < 0.0f)
+            q = -q;
+
+        int o = 0;
+        for (int i = 0; i < 4; ++i)
+            if (i != static_cast<int>(largest))
+                packed[o++] = quantize(q[i], -kSmallestThreeRange, 2.0f * kSmallestThreeRange, bits);
+    }
+
+    inline glm::quat decodeQuat(uint32_t largest, const uint32_t packed[3], uint8_t bits)
+    {
+        glm::quat q;
+        float sumSq = 0.0f;
+        int o = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (i == static_cast<int>(largest))
+                continue;
+            float v = dequantize(packed[o++], -kSmallestThreeRange, 2.0f * kSmallestThreeRange, bits);
+            q[i] = v;
+            sumSq += v * v;
+        }
+        q[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSq));
+        return glm::normalize(q);
+    }
+
+    // atan2 form: acos(dot) has no float resolution below ~1e-3 rad
+    float angleBetween(const glm::quat& a, const glm::quat& b)
+    {
+        glm::quat d = glm::conjugate(glm::normalize(a)) * glm::normalize(b);
+        float s = glm::length(glm::vec3(d.x, d.y, d.z));
+        return 2.0f * std::atan2(s, std::fabs(d.w));
+    }
+
+    /* -------- range-reduced vec3 ---------------------------------- */
+    struct RangeFit
+    {
+        glm::vec3 minV{ 0.0f };
+        glm::vec3 extent{ 0.0f };
+        uint8_t   bits = 0;
+        float     maxError = 0.0f;     /* channel units */
+    };
+
+    glm::vec3 roundTrip(const glm::vec3& v, const RangeFit& fit)
+    {
+        glm::vec3 out;
+        for (int c = 0; c < 3; ++c)
+            out[c] = dequantize(quantize(v[c], fit.minV[c], fit.extent[c], fit.bits),
+                fit.minV[c], fit.extent[c], fit.bits);
+        return out;
+    }
+
+    // Smallest width whose worst error stays inside budget (channel units);
+    // 0 bits when the whole channel fits around its midpoint
+    RangeFit fitRange(const std::vector<glm::vec3>& values, float budget)
+    {
+        RangeFit fit;
+        glm::vec3 lo = values.front(), hi = values.front();
+        for (const glm::vec3& v : values)
+        {
+            lo = glm::min(lo, v);
+            hi = glm::max(hi, v);
+        }
+
+        glm::vec3 mid = 0.5f * (lo + hi);
+        float constErr = 0.0f;
+        for (const glm::vec3& v : values)
+            constErr = std::max(constErr, glm::length(v - mid));
+
+        if (constErr <= budget)
+        {
+            fit.minV = mid;
+            fit.maxError = constErr;
+            return fit;
+        }
+
+        fit.minV = lo;
+        fit.extent = hi - lo;
+        for (uint8_t bits = 1; bits <= kMaxBits; ++bits)
+        {
+            fit.bits = bits;
+            fit.maxError = 0.0f;
+            for (const glm::vec3& v : values)
+                fit.maxError = std::max(fit.maxError, glm::length(roundTrip(v, fit) - v));
+            if (fit.maxError <= budget)
+                break;
+        }
+        return fit;
+    }
+
+    struct RotationFit
+    {
+        glm::quat constant{ 1.0f, 0.0f, 0.0f, 0.0f };
+        uint8_t   bits = 0;
+        float     maxAngle = 0.0f;     /* radians */
+    };
+
+    RotationFit fitRotation(const std::vector<glm::quat>& values, float budgetRad)
+    {
+        RotationFit fit;
+        fit.constant = glm::normalize(values.front());
+        for (const glm::quat& q : values)
+            fit.maxAngle = std::max(fit.maxAngle, angleBetween(q, fit.constant));
+        if (fit.maxAngle <= budgetRad)
+            return fit;
+
+        for (uint8_t bits = kMinRotationBits; bits <= kMaxBits; ++bits)
+        {
+            fit.bits = bits;
+            fit.maxAngle = 0.0f;
+            for (const glm::quat& q : values)
+            {
+                uint32_t largest, packed[3];
+                encodeQuat(q, bits, largest, packed);
+                fit.maxAngle = std::max(fit.maxAngle, angleBetween(q, decodeQuat(largest, packed, bits)));
+            }
+            if (fit.maxAngle <= budgetRad)
+                break;
+        }
+        return fit;
+    }
+
+} // namespace
+
+
+/* -------------------------------------------------------------- */
+/*  Build: pick widths per track, then pack every key             */
+/* -------------------------------------------------------------- */
+CompressedClip CompressedClip::build(const std::vector<BoneTrack>& boneTracks,
+    const std::vector<float>& boneReach,
+    const CompressionSettings& settings,
+    CompressionStats* stats)
+{
+    CompressedClip clip;
+    clip.tracks.resize(boneTracks.size());
+
+    CompressionStats local;
+
+    // Rotation, translation and scale errors add up at the skin, so each
+    // channel gets a third of the budget
+    const float channelBudget = settings.maxWorldError / 3.0f;
+
+    size_t totalBits = 0;
+    for (size_t b = 0; b < boneTracks.size(); ++b)
+    {
+        const BoneTrack& src = boneTracks[b];
+        CompressedTrack& dst = clip.tracks[b];
+        if (src.empty())
+            continue;
+
+        const size_t keyCount = src.keyCount();
+
+        float reach = std::max(b < boneReach.size() ? boneReach[b] : 0.0f, settings.minBoneReach);
+
+        RotationFit rot = fitRotation(src.rotations, channelBudget / reach);
+        RangeFit trans = fitRange(src.translations, channelBudget);
+        RangeFit scl = fitRange(src.scales, channelBudget / reach);
+
+        dst.animated = true;
+        dst.keyCount = static_cast<uint32_t>(keyCount);
+        dst.sparse = !src.keyFrames.empty();
+        if (dst.sparse)
+        {
+            dst.frameOffset = static_cast<uint32_t>(clip.keyFrames.size());
+            clip.keyFrames.insert(clip.keyFrames.end(), src.keyFrames.begin(), src.keyFrames.end());
+        }
+        dst.rotationBits = rot.bits;
+        dst.constantRotation = rot.constant;
+        dst.translationBits = trans.bits;
+        dst.translationMin = trans.minV;
+        dst.translationExtent = trans.extent;
+        dst.scaleBits = scl.bits;
+        dst.scaleMin = scl.minV;
+        dst.scaleExtent = scl.extent;
+
+        dst.keyStride = static_cast<uint16_t>(
+            1 + (rot.bits ? 2 + 3 * rot.bits : 0) + 3 * trans.bits + 3 * scl.bits);
+        dst.bitOffset = static_cast<uint32_t>(totalBits);
+        totalBits += size_t(dst.keyStride) * keyCount;
+
+        local.rawBytes += src.sizeInBytes();
+        local.constantChannels += (rot.bits == 0) + (trans.bits == 0) + (scl.bits == 0);
+        local.maxWorldError = std::max(local.maxWorldError,
+            rot.maxAngle * reach + trans.maxError + scl.maxError * reach);
+    }
+
+    clip.stream.assign((totalBits + 7) / 8 + sizeof(uint64_t), 0);
+
+    for (size_t b = 0; b < boneTracks.size(); ++b)
+    {
+        const CompressedTrack& dst = clip.tracks[b];
+        if (!dst.animated)
+            continue;
+
+        const BoneTrack& src = boneTracks[b];
+        for (size_t k = 0; k < dst.keyCount; ++k)
+        {
+            size_t pos = dst.bitOffset + k * size_t(dst.keyStride);
+
+            writeBits(clip.stream, pos, 1, src.changed[k] ? 1u : 0u);
+            pos += 1;
+
+            if (dst.rotationBits)
+            {
+                uint32_t largest, packed[3];
+                encodeQuat(src.rotations[k], dst.rotationBits, largest, packed);
+                writeBits(clip.stream, pos, 2, largest);
+                pos += 2;
+                for (int c = 0; c < 3; ++c, pos += dst.rotationBits)
+                    writeBits(clip.stream, pos, dst.rotationBits, packed[c]);
+            }
+
+            for (int c = 0; c < 3 && dst.translationBits; ++c, pos += dst.translationBits)
+                writeBits(clip.stream, pos, dst.translationBits,
+                    quantize(src.translations[k][c], dst.translationMin[c], dst.translationExtent[c], dst.translationBits));
+
+            for (int c = 0; c < 3 && dst.scaleBits; ++c, pos += dst.scaleBits)
+                writeBits(clip.stream, pos, dst.scaleBits,
+                    quantize(src.scales[k][c], dst.scaleMin[c], dst.scaleExtent[c], dst.scaleBits));
+        }
+    }
+
+    local.compressedBytes = clip.sizeInBytes();
+    if (stats)
+        *stats = local;
+    return clip;
+}
+
+bool CompressedClip::keyChanged(size_t bone, size_t key) const
+{
+    const CompressedTrack& tr = tracks[bone];
+    return readBits(stream.data(), tr.bitOffset + key * size_t(tr.keyStride), 1) != 0;
+}
+
+size_t CompressedClip::sizeInBytes() const
+{
+    return stream.size() + tracks.size() * sizeof(CompressedTrack) + keyFrames.size() * sizeof(uint16_t);
+}
+
+/* -------------------------------------------------------------- */
+/*  Decode one key - a handful of shifts per channel              */
+/* -------------------------------------------------------------- */
+void CompressedClip::decodeKey(size_t bone, size_t key,
+    glm::vec3& translation, glm::quat& rotation, glm::vec3& scale) const
+{
+    const CompressedTrack& tr = tracks[bone];
+    const uint8_t* bits = stream.data();
+    size_t pos = tr.bitOffset + key * size_t(tr.keyStride) + 1;
+
+    if (tr.rotationBits)
+    {
+        uint32_t largest = readBits(bits, pos, 2);
+        pos += 2;
+        uint32_t packed[3];
+        for (int c = 0; c < 3; ++c, pos += tr.rotationBits)
+            packed[c] = readBits(bits, pos, tr.rotationBits);
+        rotation = decodeQuat(largest, packed, tr.rotationBits);
+    }
+    else
+    {
+        rotation = tr.constantRotation;
+    }
+
+    translation = tr.translationMin;
+    for (int c = 0; c < 3 && tr.translationBits; ++c, pos += tr.translationBits)
+        translation[c] = dequantize(readBits(bits, pos, tr.translationBits),
+            tr.translationMin[c], tr.translationExtent[c], tr.translationBits);
+
+    scale = tr.scaleMin;
+    for (int c = 0; c < 3 && tr.scaleBits; ++c, pos += tr.scaleBits)
+        scale[c] = dequantize(readBits(bits, pos, tr.scaleBits),
+            tr.scaleMin[c], tr.scaleExtent[c], tr.scaleBits);
+}
+
+/* -------------------------------------------------------------- */
+/*  Tangents: controls share the track's rotation width, slopes   */
+/*  get their own range against the translation budget            */
+/* -------------------------------------------------------------- */
+void CompressedClip::packTangents(const std::vector<TrackTangents>& tangents,
+    const CompressionSettings& settings)
+{
+    const float channelBudget = settings.maxWorldError / 3.0f;
+
+    size_t totalBits = 0;
+    for (size_t b = 0; b < tracks.size() && b < tangents.size(); ++b)
+    {
+        CompressedTrack& tr = tracks[b];
+        const TrackTangents& src = tangents[b];
+
+        tr.tangentControls = tr.animated && tr.rotationBits && src.controls.size() == tr.keyCount;
+        tr.tangentSlopes = tr.animated && src.slopes.size() == tr.keyCount && tr.keyCount > 0;
+        tr.slopeBits = 0;
+        if (tr.tangentSlopes)
+        {
+            RangeFit fit = fitRange(src.slopes, channelBudget);
+            tr.slopeBits = fit.bits;
+            tr.slopeMin = fit.minV;
+            tr.slopeExtent = fit.extent;
+        }
+
+        tr.tangentStride = static_cast<uint16_t>(
+            (tr.tangentControls ? 2 + 3 * tr.rotationBits : 0) + 3 * tr.slopeBits);
+        tr.tangentBitOffset = static_cast<uint32_t>(totalBits);
+        totalBits += size_t(tr.tangentStride) * tr.keyCount;
+    }
+
+    tangentStream.assign(totalBits ? (totalBits + 7) / 8 + sizeof(uint64_t) : 0, 0);
+
+    for (size_t b = 0; b < tracks.size() && b < tangents.size(); ++b)
+    {
+        const CompressedTrack& tr = tracks[b];
+        if (!tr.tangentStride)
+            continue;
+
+        const TrackTangents& src = tangents[b];
+        for (size_t k = 0; k < tr.keyCount; ++k)
+        {
+            size_t pos = tr.tangentBitOffset + k * size_t(tr.tangentStride);
+
+            if (tr.tangentControls)
+            {
+                uint32_t largest, packed[3];
+                encodeQuat(src.controls[k], tr.rotationBits, largest, packed);
+                writeBits(tangentStream, pos, 2, largest);
+                pos += 2;
+                for (int c = 0; c < 3; ++c, pos += tr.rotationBits)
+                    writeBits(tangentStream, pos, tr.rotationBits, packed[c]);
+            }
+
+            for (int c = 0; c < 3 && tr.slopeBits; ++c, pos += tr.slopeBits)
+                writeBits(tangentStream, pos, tr.slopeBits,
+                    quantize(src.slopes[k][c], tr.slopeMin[c], tr.slopeExtent[c], tr.slopeBits));
+        }
+    }
+}
+
+void CompressedClip::decodeTangent(size_t bone, size_t key,
+    glm::quat& control, glm::vec3& slope) const
+{
+    const CompressedTrack& tr = tracks[bone];
+    const uint8_t* bits = tangentStream.data();
+    size_t pos = tr.tangentBitOffset + key * size_t(tr.tangentStride);
+
+    if (tr.tangentControls)
+    {
+        uint32_t largest = readBits(bits, pos, 2);
+        pos += 2;
+        uint32_t packed[3];
+        for (int c = 0; c < 3; ++c, pos += tr.rotationBits)
+            packed[c] = readBits(bits, pos, tr.rotationBits);
+        control = decodeQuat(largest, packed, tr.rotationBits);
+    }
+
+    if (tr.tangentSlopes)
+    {
+        slope = tr.slopeMin;
+        for (int c = 0; c < 3 && tr.slopeBits; ++c, pos += tr.slopeBits)
+            slope[c] = dequantize(readBits(bits, pos, tr.slopeBits),
+                tr.slopeMin[c], tr.slopeExtent[c], tr.slopeBits);
+    }
+}
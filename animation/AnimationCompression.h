@@ -0,0 +1,113 @@
+// AnimationCompression.h
+#ifndef ANIMATION_COMPRESSION_H
+#define ANIMATION_COMPRESSION_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+struct BoneTrack;
+struct TrackTangents;
+
+/* Error budget for the quantised clip format. Errors are measured in
+   world units at the furthest point a bone moves (its reach), so a
+   pelvis gets more rotation bits than a fingertip.                     */
+struct CompressionSettings
+{
+    bool  enabled = true;
+    float maxWorldError = 0.0005f;   /* per bone, split across T/R/S */
+    float minBoneReach = 0.1f;       /* skin extent assumed past the last joint */
+
+    /* key reduction runs first, on the exact keys */
+    bool  reduceKeys = true;
+    float maxReductionError = 0.0005f;   /* cubic/squad reconstruction vs. the dense bake */
+};
+
+/* Per clip summary, logged once the runtime tracks are built. Sizes
+   are the containers' resident bytes, not allocator overhead.          */
+struct CompressionStats
+{
+    size_t keyframeBytes = 0;        /* baked keyframe maps, released once the tracks exist */
+    size_t runtimeBytes = 0;         /* everything sampling keeps: tracks or stream, tangents, key times */
+    size_t rawBytes = 0;             /* float tracks after key reduction */
+    size_t compressedBytes = 0;
+    size_t tangentBytes = 0;         /* per-key cubic data, packed or float */
+    size_t constantChannels = 0;
+    float  maxWorldError = 0.0f;     /* worst measured error over all keys */
+};
+
+/* One animated bone: fixed bit widths per channel so key k starts at
+   bitOffset + k * keyStride and can be decoded without touching its
+   neighbours. Each key leads with its BoneTrack::changed bit.
+   A width of 0 means the channel is constant.                         */
+struct CompressedTrack
+{
+    uint32_t bitOffset = 0;
+    uint32_t keyCount = 0;
+    uint32_t frameOffset = 0;        /* into CompressedClip::keyFrames when sparse */
+    uint16_t keyStride = 0;          /* bits per key */
+    uint8_t  rotationBits = 0;       /* per smallest-three component */
+    uint8_t  translationBits = 0;    /* per component */
+    uint8_t  scaleBits = 0;          /* per component */
+    bool     animated = false;
+    bool     sparse = false;
+
+    glm::quat constantRotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 translationMin{ 0.0f }, translationExtent{ 0.0f };
+    glm::vec3 scaleMin{ 1.0f }, scaleExtent{ 0.0f };
+
+    /* TrackTangents of the decoded keys, in the tangent stream: squad
+       controls at rotationBits, range-reduced slopes at slopeBits */
+    uint32_t tangentBitOffset = 0;
+    uint16_t tangentStride = 0;      /* bits per key */
+    uint8_t  slopeBits = 0;
+    bool     tangentControls = false;
+    bool     tangentSlopes = false;
+    glm::vec3 slopeMin{ 0.0f }, slopeExtent{ 0.0f };
+};
+
+/* Quantised, bone-indexed clip: smallest-three rotations and
+   range-reduced translation/scale packed into one bit stream. */
+class CompressedClip
+{
+public:
+    /* tracks/boneReach are indexed like Model::getBones() */
+    static CompressedClip build(const std::vector<BoneTrack>& tracks,
+        const std::vector<float>& boneReach,
+        const CompressionSettings& settings,
+        CompressionStats* stats = nullptr);
+
+    bool   empty() const { return tracks.empty(); }
+    size_t getTrackCount() const { return tracks.size(); }
+    bool   isAnimated(size_t bone) const { return tracks[bone].animated; }
+    size_t getKeyCount(size_t bone) const { return tracks[bone].keyCount; }
+    const uint16_t* getKeyFrames(size_t bone) const
+    {
+        return tracks[bone].sparse ? keyFrames.data() + tracks[bone].frameOffset : nullptr;
+    }
+    size_t sizeInBytes() const;
+    size_t tangentSizeInBytes() const { return tangentStream.size(); }
+
+    void decodeKey(size_t bone, size_t key,
+        glm::vec3& translation, glm::quat& rotation, glm::vec3& scale) const;
+    bool keyChanged(size_t bone, size_t key) const;   /* BoneTrack::changed, kept exact */
+
+    /* tangents are worked out from the decoded keys, so they are packed
+       after build; bone-indexed like the tracks */
+    void packTangents(const std::vector<TrackTangents>& tangents,
+        const CompressionSettings& settings);
+    /* leaves control/slope as passed where the track stores none */
+    void decodeTangent(size_t bone, size_t key,
+        glm::quat& control, glm::vec3& slope) const;
+
+private:
+    std::vector<CompressedTrack> tracks;
+    std::vector<uint8_t>         stream;   /* padded so 8-byte reads never overrun */
+    std::vector<uint16_t>        keyFrames;
+    std::vector<uint8_t>         tangentStream;   /* same padding; empty without tangents */
+};
+
+#endif // ANIMATION_COMPRESSION_H
@@ -1,6 +1,11 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "AnimationController.h"
 #include "../common_utils/Logger.h"
+#include "../common_utils/ThreadPool.h"
+#include "../common_utils/AllocationCounter.h"
+#include "JitterTrace.h"
+#include "PoseDump.h"
+#include <algorithm>
 #include <fstream>
 #include <glm/gtx/component_wise.hpp> // for glm::all(glm::equal ) style helpers
 #include <glm/gtc/epsilon.hpp>  // epsilonEqual + all/any/not_ helpers
@@ -28,11 +33,21 @@ static void dumpBoneDebugTrace(
 
 AnimationController::AnimationController(Model* model)
     : model(model)
-    , currentAnimation(nullptr)
-    , animationTime(0.0f)
 {
 }
 
+AnimationController::~AnimationController()
+{
+    // Background bakes read the model; let them finish first
+    for (const AnimationLoadHandle& request : pendingLoads)
+        if (request->task.valid())
+            request->task.wait();
+
+    // The model may still be drawing from one of our palette tables
+    if (model && !skinPalettes.empty())
+        model->useSkinPalette(nullptr);
+}
+
 
 /* return true if every element differs by less than eps */
 static bool matNearlyEqual(const glm::mat4& A,
@@ -51,7 +66,8 @@ static bool matNearlyEqual(const glm::mat4& A,
      Registers or reloads a clip and (optionally) makes it
       the active animation.
      If forceReload == true and a clip with the same name
-      already exists, the old one is deleted and replaced.
+      already exists, it is rebuilt and replaced; other
+      controllers keep playing the old one.
 --------------------------------------------------------------*/
 bool AnimationController::loadAnimation(const std::string& name,
     const std::string& filePath,
@@ -60,40 +76,275 @@ bool AnimationController::loadAnimation(const std::string& name,
     /* ----------------------------------------------------------
        1.  Handle duplicates / hot-reloads
     ---------------------------------------------------------- */
-    auto it = animations.find(name);
-
-    if (it != animations.end() && !forceReload)
+    if (!forceReload && animations.count(name))
         return true;                       // nothing to do
 
-    if (it != animations.end())            // replace old clip
-    {
-        delete it->second;
-        animations.erase(it);
-    }
-
     /* ----------------------------------------------------------
        2.  Load the new clip
     ---------------------------------------------------------- */
-    Animation* clip = new Animation(filePath, model);
-    if (!clip->isLoaded())
+    std::shared_ptr<Animation> clip =
+        ClipLibrary::shared().acquire(filePath, model, compressionSettings, forceReload);
+    if (!clip)
     {
         Logger::log("Failed to load animation: " + filePath,
             Logger::ERROR);
-        delete clip;
         return false;
     }
+
+    std::shared_ptr<const SkinPaletteTable> palettes;
+    if (bakeSkinPalettes && model && clip->isLoaded())
+        palettes = ClipLibrary::shared().getSkinPalettes(clip, *model);
+
+    registerClip(name, clip, std::move(palettes));
+
+    // The clip's bake corrections reached the trace when it was built
+    JitterTrace::shared().saveAsync();
+    return true;
+}
+
+/*--------------------------------------------------------------
+    loadAnimations
+    - Batch form of loadAnimation: every clip is imported and
+      baked on the shared thread pool, then registered on the
+      calling thread in list order, so the result is the same
+      as loading them one after another.
+    - A name listed twice loads once (the first entry, or the
+      last one when forceReload is set).
+    - Returns the number of clips loaded.
+--------------------------------------------------------------*/
+size_t AnimationController::loadAnimations(
+    const std::vector<std::pair<std::string, std::string>>& clips,
+    bool forceReload)
+{
+    std::vector<std::pair<std::string, std::string>> pending;
+    std::unordered_map<std::string, size_t> slotByName;
+    for (const auto& entry : clips)
+    {
+        if (!forceReload && animations.count(entry.first))
+            continue;                      // already registered
+
+        auto slot = slotByName.find(entry.first);
+        if (slot == slotByName.end())
+        {
+            slotByName[entry.first] = pending.size();
+            pending.push_back(entry);
+        }
+        else if (forceReload)
+        {
+            pending[slot->second].second = entry.second;
+        }
+    }
+
+    // Loads are independent: each clip owns its importer and bake state,
+    // and clips another character already loaded come back at once
+    std::vector<std::shared_ptr<Animation>> loadedClips(pending.size());
+    std::vector<std::shared_ptr<const SkinPaletteTable>> loadedPalettes(pending.size());
+    ThreadPool::shared().parallelFor(pending.size(), [&](size_t i) {
+        loadedClips[i] = ClipLibrary::shared().acquire(pending[i].second, model, compressionSettings, forceReload);
+        if (bakeSkinPalettes && model && loadedClips[i] && loadedClips[i]->isLoaded())
+            loadedPalettes[i] = ClipLibrary::shared().getSkinPalettes(loadedClips[i], *model);
+        });
+
+    size_t loadedCount = 0;
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        if (!loadedClips[i])
+        {
+            Logger::log("Failed to load animation: " + pending[i].second,
+                Logger::ERROR);
+            continue;
+        }
+        registerClip(pending[i].first, std::move(loadedClips[i]), std::move(loadedPalettes[i]));
+        ++loadedCount;
+    }
+
+    // One save for the batch, written off this thread
+    if (loadedCount > 0)
+        JitterTrace::shared().saveAsync();
+    return loadedCount;
+}
+
+/*--------------------------------------------------------------
+    requestAnimation
+    - Starts loading a clip on the thread pool and returns at
+      once. Nothing changes until a later update() registers the
+      finished clip, so the current clip keeps playing meanwhile.
+    - A clip that is already loaded, or already on its way,
+      is not loaded twice; the existing handle is returned.
+    - With playWhenReady, the most recent such request becomes
+      the current clip at the start of the update() after it is
+      ready.
+--------------------------------------------------------------*/
+AnimationLoadHandle AnimationController::requestAnimation(const std::string& name,
+    const std::string& filePath,
+    bool playWhenReady)
+{
+    if (playWhenReady)
+        playWhenLoaded = name;
+
+    for (const AnimationLoadHandle& request : pendingLoads)
+        if (request->name == name)
+            return request;
+
+    auto request = std::make_shared<AnimationLoadRequest>();
+    request->name = name;
+    request->filePath = filePath;
+
+    if (animations.count(name))
+    {
+        request->status = AnimationLoadRequest::Status::Ready;
+        return request;
+    }
+
+    // The loader only sees its own copies and the (read-only) model;
+    // it bakes the palettes too, so registering the clip costs nothing
+    AnimationLoadRequest* target = request.get();
+    const CompressionSettings settings = compressionSettings;
+    const Model* sourceModel = model;
+    const bool bakePalettes = bakeSkinPalettes;
+    request->task = ThreadPool::shared().submit([target, filePath, settings, sourceModel, bakePalettes]() {
+        try {
+            target->clip = ClipLibrary::shared().acquire(filePath, sourceModel, settings);
+            if (bakePalettes && sourceModel && target->clip && target->clip->isLoaded())
+                target->palettes = ClipLibrary::shared().getSkinPalettes(target->clip, *sourceModel);
+        }
+        catch (const std::exception& e) {
+            Logger::log("Exception while loading " + filePath + ": " + e.what(), Logger::ERROR);
+        }
+        target->baked.store(true, std::memory_order_release);
+        });
+
+    pendingLoads.push_back(request);
+    Logger::log("Loading " + name + " in the background", Logger::INFO);
+    return request;
+}
+
+bool AnimationController::isLoading(const std::string& name) const
+{
+    for (const AnimationLoadHandle& request : pendingLoads)
+        if (request->name == name)
+            return true;
+    return false;
+}
+
+bool AnimationController::shareClips(const AnimationController& other)
+{
+    if (!model || !other.model ||
+        ClipLibrary::skeletonSignature(*model) != ClipLibrary::skeletonSignature(*other.model))
+    {
+        Logger::log("shareClips: the models' skeletons differ", Logger::ERROR);
+        return false;
+    }
+
+    for (const auto& [name, clip] : other.animations)
+        if (!animations.count(name))
+            animations[name] = clip;
+
+    if (!playback.clip && other.playback.clip)
+    {
+        playback.clip = other.playback.clip;
+        playback.time = other.playback.time;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------
+    finishPendingLoads
+    - Registers every background load that has finished, in
+      request order, then swaps to the clip asked to play if it
+      is ready. Called at the top of update(), between frames.
+--------------------------------------------------------------*/
+void AnimationController::finishPendingLoads()
+{
+    bool registered = false;
+    for (size_t i = 0; i < pendingLoads.size();)
+    {
+        AnimationLoadRequest& request = *pendingLoads[i];
+        if (!request.baked.load(std::memory_order_acquire))
+        {
+            ++i;
+            continue;
+        }
+
+        request.task.get();
+        if (request.clip)
+        {
+            registerClip(request.name, std::move(request.clip), std::move(request.palettes));
+            request.status = AnimationLoadRequest::Status::Ready;
+            registered = true;
+        }
+        else
+        {
+            Logger::log("Failed to load animation: " + request.filePath,
+                Logger::ERROR);
+            request.clip.reset();
+            request.status = AnimationLoadRequest::Status::Failed;
+            if (playWhenLoaded == request.name)
+                playWhenLoaded.clear();
+        }
+        pendingLoads.erase(pendingLoads.begin() + i);
+    }
+
+    // No file I/O at the frame boundary: the trace is saved off-thread
+    if (registered)
+        JitterTrace::shared().saveAsync();
+
+    if (!playWhenLoaded.empty() && animations.count(playWhenLoaded))
+    {
+        const std::string name = playWhenLoaded;
+        playWhenLoaded.clear();
+
+        if (playback.clip != animations[name])
+        {
+            setCurrentAnimation(name);
+            debugFrame = 0;
+        }
+    }
+}
+
+/*--------------------------------------------------------------
+    registerClip
+    - Binds a loaded clip to a name, replacing any clip of the
+      same name, and auto-binds it. Only swaps pointers, as it
+      runs at the frame boundary; the jump scan and bind-pose
+      checks run only with Animation DEBUG logging on.
+    - Main thread only.
+--------------------------------------------------------------*/
+void AnimationController::registerClip(const std::string& name, std::shared_ptr<Animation> clip,
+    std::shared_ptr<const SkinPaletteTable> palettes)
+{
+    auto it = animations.find(name);
+    if (it != animations.end())            // replace old clip
+    {
+        if (it->second == clip)
+            return;                        // same shared clip, nothing changes
+        if (playback.clip == it->second)
+            playback.clip = nullptr;    // rebinds to the new clip below
+        auto table = skinPalettes.find(it->second.get());
+        if (table != skinPalettes.end())
+        {
+            model->useSkinPalette(nullptr);
+            skinPalettes.erase(table);
+        }
+        animations.erase(it);              // freed once no one else plays it
+    }
     animations[name] = clip;
 
+    // Built by the loader; bakedPaletteFor builds any that are missing
+    if (palettes)
+        skinPalettes[clip.get()] = std::move(palettes);
+
     /* ----------------------------------------------------------
        3.  Auto-bind if this is the selected clip
            (or if nothing is currently playing)
     ---------------------------------------------------------- */
-    if (currentAnimation == nullptr || currentAnimation->getName() == name)
+    if (playback.clip == nullptr || playback.clip->getName() == name)
     {
-        currentAnimation = clip;
+        playback.clip = clip;
 
         // UPDATE: start slightly after 0 to avoid sampling the bind pose
-        animationTime = 1e-5f;
+        playback.time = 1e-5f;
+        playback.cursor = SampleCursor{};
 
         Logger::log("NOW PLAYING: " + name +
             " | keyframes = " +
@@ -102,14 +353,16 @@ bool AnimationController::loadAnimation(const std::string& name,
             std::to_string(clip->getClipDurationSeconds()) + " s",
             Logger::INFO);
 
-        scanForTranslationJumps(clip);
+        // Decodes every key into maps: debug sessions only
+        if (LOG_ENABLED(Logger::DEBUG, Logger::Animation))
+            scanForTranslationJumps(clip.get());
 
     }
 
     /* ----------------------------------------------------------
    OPTIONAL: verify frame 0 pose matches the model bind pose
 ---------------------------------------------------------- */
-    if (clip->isLoaded())
+    if (clip->isLoaded() && LOG_ENABLED(Logger::DEBUG, Logger::Animation))
     {
         std::map<std::string, glm::mat4> firstPose;
         clip->interpolateKeyframes(1e-6f, firstPose);   // ~frame 0
@@ -155,10 +408,6 @@ bool AnimationController::loadAnimation(const std::string& name,
             Logger::log("[OK] First frame of '" + name +
                 "' matches bind pose.", Logger::INFO);
     }
-
-
-
-    return true;
 }
 
 void scanForTranslationJumps(const Animation* anim, float threshold)
@@ -166,21 +415,18 @@ void scanForTranslationJumps(const Animation* anim, float threshold)
 {
     if (!anim) return;
 
-    const auto& keyframes = anim->getKeyframes();
-    if (keyframes.size() < 2) return;
+    if (anim->getKeyframeCount() < 2) return;
+    const std::vector<Keyframe> keyframes = anim->getKeyframes();
 
     Logger::log("=== Translation Jitter Scan Start ===", Logger::WARNING);
 
-    for (const auto& bone : anim->getKeyframes().front().boneTransforms)
+    for (const auto& bone : keyframes.front().boneTransforms)
     {
         const std::string& boneName = bone.first;
         for (size_t i = 0; i < keyframes.size() - 1; ++i)
         {
-            const glm::mat4& m0 = keyframes[i].boneTransforms.at(boneName);
-            const glm::mat4& m1 = keyframes[i + 1].boneTransforms.at(boneName);
-
-            glm::vec3 t0(m0[3]);
-            glm::vec3 t1(m1[3]);
+            const glm::vec3& t0 = keyframes[i].boneTransforms.at(boneName).translation;
+            const glm::vec3& t1 = keyframes[i + 1].boneTransforms.at(boneName).translation;
             glm::vec3 delta = t1 - t0;
 
             if (glm::length(delta) > threshold)
@@ -206,25 +452,27 @@ void AnimationController::setCurrentAnimation(const std::string& name)
         return;
     }
 
-    Animation* newClip = it->second;
+    const std::shared_ptr<Animation>& newClip = it->second;
 
     // Avoid resetting if this is already the active animation
-    if (currentAnimation == newClip)
+    if (playback.clip == newClip)
     {
         Logger::log("INFO: Animation [" + name + "] is already playing.", Logger::INFO);
         return;
     }
 
-    // Run bind mismatch check only once per clip
-    if (!newClip->bindMismatchChecked())
+    // Run bind mismatch check only once per clip; like registerClip's
+    // checks it is a debug diagnostic, kept off the frame boundary
+    if (!newClip->bindMismatchChecked() && LOG_ENABLED(Logger::DEBUG, Logger::Animation))
         newClip->checkBindMismatch(model);
 
-    currentAnimation = newClip;
-    animationTime = 0.00001f;  // Ensure we skip t=0 precision issues
+    playback.clip = newClip;
+    playback.time = 0.00001f;  // Ensure we skip t=0 precision issues
+    playback.cursor = SampleCursor{};
 
     Logger::log("NOW PLAYING: [" + name + "]"
-        "  keyframes=" + std::to_string(currentAnimation->getKeyframeCount()) +
-        "  duration=" + std::to_string(currentAnimation->getClipDurationSeconds()) + "s",
+        "  keyframes=" + std::to_string(playback.clip->getKeyframeCount()) +
+        "  duration=" + std::to_string(playback.clip->getClipDurationSeconds()) + "s",
         Logger::INFO);
 }
 
@@ -246,7 +494,7 @@ const glm::mat4& AnimationController::bindGlobalNoScale
   - deltaTime arrives in seconds from the game loop.
   - We convert it to fractional Assimp "ticks":
         deltaTicks = deltaTime * ticksPerSecond;
-  - animationTime is stored in ticks because the rest of the
+  - the playback time is stored in ticks because the rest of the
     controller and applyToModel() expect that unit.
 ------------------------------------------------------------------*/
 /*------------------------------------------------------------------
@@ -255,11 +503,20 @@ const glm::mat4& AnimationController::bindGlobalNoScale
 
 void AnimationController::update(float deltaTime)
 {
-    if (!currentAnimation)
+    // Frame boundary: last frame's scratch is dead, and the heap count
+    // for this frame (update + applyToModel) starts here
+    frameArena.reset();
+    frameAllocationStart = AllocationCounter::getThreadCount();
+
+    // Pick up clips finished in the background
+    if (!pendingLoads.empty() || !playWhenLoaded.empty())
+        finishPendingLoads();
+
+    if (!playback.clip)
         return;
 
-    const auto& keyframes = currentAnimation->getKeyframes();
-    if (keyframes.empty())
+    const size_t frameCount = playback.clip->getKeyframeCount();
+    if (frameCount == 0)
         return;
 
     // Handle rewind
@@ -269,8 +526,7 @@ void AnimationController::update(float deltaTime)
     }
 
     // Frame stepping setup
-    static float timeAccumulator = 0.0f;
-    float ticksPerSecond = currentAnimation->getTicksPerSecond();
+    float ticksPerSecond = playback.clip->getTicksPerSecond();
     if (ticksPerSecond <= 0.0f) {
         Logger::log("WARNING: ticksPerSecond was 0. Defaulting to 60 FPS.", Logger::WARNING);
         ticksPerSecond = 60.0f;
@@ -280,15 +536,15 @@ void AnimationController::update(float deltaTime)
     // Auto-play with optional loop
     if (debugPlay)
     {
-        timeAccumulator += deltaTime;
-        while (timeAccumulator >= FRAME_TIME)
+        playback.timeAccumulator += deltaTime;
+        while (playback.timeAccumulator >= FRAME_TIME)
         {
-            int lastFrameIndex = static_cast<int>(keyframes.size()) - 1;
+            int lastFrameIndex = static_cast<int>(frameCount) - 1;
 
             if (!loopPlayback && debugFrame >= lastFrameIndex)
             {
                 debugPlay = false;
-                timeAccumulator = 0.0f;
+                playback.timeAccumulator = 0.0f;
                 break;
             }
 
@@ -297,31 +553,31 @@ void AnimationController::update(float deltaTime)
             {
                 // Don't allow overstep
                 debugPlay = false;
-                timeAccumulator = 0.0f;
+                playback.timeAccumulator = 0.0f;
                 break;
             }
-            debugFrame = loopPlayback ? (debugFrame + 1) % keyframes.size() : nextFrame;
-            timeAccumulator -= FRAME_TIME;
+            debugFrame = loopPlayback ? (debugFrame + 1) % frameCount : nextFrame;
+            playback.timeAccumulator -= FRAME_TIME;
         }
     }
 
     // Manual step
     if (debugStep) {
         if (loopPlayback) {
-            debugFrame = (debugFrame + 1) % static_cast<int>(keyframes.size());
+            debugFrame = (debugFrame + 1) % static_cast<int>(frameCount);
         }
         else {
-            if (debugFrame < static_cast<int>(keyframes.size()) - 1)
+            if (debugFrame < static_cast<int>(frameCount) - 1)
                 debugFrame++;
         }
         debugStep = false;
     }
 
-    debugFrame = std::clamp(debugFrame, 0, static_cast<int>(keyframes.size()) - 1);
-    animationTime = keyframes[debugFrame].time;
+    debugFrame = std::clamp(debugFrame, 0, static_cast<int>(frameCount) - 1);
+    playback.time = playback.clip->getKeyTime(debugFrame);
 
-    Logger::log("DEBUG: Frame #" + std::to_string(debugFrame) +
-        " at t=" + std::to_string(animationTime), Logger::INFO);
+    LOG_DEBUG(Logger::Animation, "Frame #" + std::to_string(debugFrame) +
+        " at t=" + std::to_string(playback.time));
 
 
 
@@ -331,108 +587,140 @@ void AnimationController::update(float deltaTime)
 
 void AnimationController::applyToModel(Model* model)
 {
-    if (!model || !currentAnimation) return;
+    if (!model || !playback.clip) return;
 
     if (debugFrame == 59)
     {
-        Logger::log("DEBUG: Frame 59 | animationTime = " + std::to_string(animationTime), Logger::WARNING);
+        LOG_DEBUG(Logger::Animation, "Frame 59 | animationTime = " + std::to_string(playback.time));
     }
 
-    // 1. local-pose interpolation
-    std::map<std::string, glm::mat4> localBoneMatrices;
-    if (lockToExactFrame && debugFrame >= 0 && debugFrame < static_cast<int>(currentAnimation->getKeyframes().size())) {
-        const Keyframe& kf = currentAnimation->getKeyframes()[debugFrame];
-        for (const auto& [boneName, mat] : kf.boneTransforms) {
-            localBoneMatrices[boneName] = mat;
+    // Baked palettes: update() left us on key debugFrame, whose skin
+    // matrices are already in the table
+    const SkinPaletteTable* baked = bakedPaletteFor(model, true);
+    if (baked && debugFrame >= 0 && static_cast<size_t>(debugFrame) < baked->getFrameCount())
+        model->useSkinPalette(baked->getFrame(static_cast<size_t>(debugFrame)));
+    else
+        applySampledPose(model);
+
+    // === Dump full pose once per clip (written off this thread) ===
+    PoseDump::requestOnce(playback.clip);
+
+    lastFrameAllocations = AllocationCounter::getThreadCount() - frameAllocationStart;
+}
+
+const glm::mat4* AnimationController::evaluate()
+{
+    const glm::mat4* palette = nullptr;
+    if (model && playback.clip)
+    {
+        // Same choice as applyToModel; the model is only read
+        const SkinPaletteTable* baked = bakedPaletteFor(model, false);
+        if (baked && debugFrame >= 0 && static_cast<size_t>(debugFrame) < baked->getFrameCount())
+        {
+            palette = baked->getFrame(static_cast<size_t>(debugFrame));
         }
-    }
-    else {
-        currentAnimation->interpolateKeyframes(animationTime, localBoneMatrices);
+        else
+        {
+            const size_t boneCount = model->getBones().size();
+            skinPalette.resize(boneCount);
+            model->computeSkinPalette(sampleGlobalPose(*model), boneCount, skinPalette.data());
+            palette = skinPalette.data();
+        }
+
+        PoseDump::requestOnce(playback.clip);
     }
 
-    // Fill missing with bind pose
-    for (const auto& bone : model->getBones())
+    lastFrameAllocations = AllocationCounter::getThreadCount() - frameAllocationStart;
+    return palette;
+}
+
+const SkinPaletteTable* AnimationController::bakedPaletteFor(Model* target, bool showing)
+{
+    if (!bakeSkinPalettes || !playback.clip || !playback.clip->isLoaded())
+        return nullptr;
+
+    std::shared_ptr<const SkinPaletteTable>& table = skinPalettes[playback.clip.get()];
+    if (!table || !table->matches(*playback.clip, *target))
     {
-        const std::string& name = bone.name;
-        if (!localBoneMatrices.count(name))
-            localBoneMatrices[name] = model->getLocalBindPose(name);
+        if (table && showing)
+            target->useSkinPalette(nullptr);    // it may be showing the old table
+        table = ClipLibrary::shared().getSkinPalettes(playback.clip, *target);
     }
+    return table.get();
+}
 
-    // 2. build global transforms
-    std::map<std::string, glm::mat4> globalBoneMatrices;
-    for (const auto& [boneName, _] : localBoneMatrices)
-        globalBoneMatrices[boneName] =
-        buildGlobalTransform(boneName, localBoneMatrices, model, globalBoneMatrices);
+const glm::mat4* AnimationController::sampleGlobalPose(const Model& target)
+{
+    const size_t boneCount = target.getBones().size();
 
-    // 3. final skin matrices and debug dump
-    static std::unordered_set<int> dumpedFrames;
+    // Pose scratch comes from the frame arena, released by the next update()
+    const size_t poseCount = std::max(boneCount, playback.clip->getTrackCount());
+    glm::mat4* localPose = frameArena.allocateArray<glm::mat4>(poseCount);
+    glm::mat4* globalPose = frameArena.allocateArray<glm::mat4>(boneCount);
+
+    // 1. local-pose sampling; bones the clip doesn't animate keep their bind pose
+    const std::vector<glm::mat4>& bindPoses = target.getLocalBindPoses();
+    std::copy(bindPoses.begin(), bindPoses.end(), localPose);
+    std::fill(localPose + bindPoses.size(), localPose + poseCount, glm::mat4(1.0f));
+
+    if (lockToExactFrame && debugFrame >= 0 && debugFrame < static_cast<int>(playback.clip->getKeyframeCount())) {
+        playback.clip->getKeyPose(static_cast<size_t>(debugFrame), localPose);
+    }
+    else {
+        playback.clip->sampleBoneTracks(playback.time, localPose, &playback.cursor);
+    }
+
+    // 2. build global transforms: one pass, parents first
+    target.computeGlobalPose(localPose, globalPose);
+    return globalPose;
+}
+
+void AnimationController::applySampledPose(Model* model)
+{
+    const std::vector<Bone>& bones = model->getBones();
+    const size_t boneCount = bones.size();
+    const glm::mat4* globalPose = sampleGlobalPose(*model);
 
+    // 3. final skin matrices and debug dump
     bool shouldDump = false;
     int targetFrames[] = { 51, 52, 53, 54, 55, 56, 57, 58, 59 };
 
     for (int tf : targetFrames) {
-        if (debugFrame == tf && !dumpedFrames.count(tf)) {
-            dumpedFrames.insert(tf);
+        const uint32_t bit = 1u << (tf - targetFrames[0]);
+        if (debugFrame == tf && !(playback.tracedFrames & bit)) {
+            playback.tracedFrames |= bit;
             shouldDump = true;
             Logger::log("==== DEBUG DUMP FOR FRAME " + std::to_string(debugFrame) + " ====", Logger::WARNING);
-            dumpBoneDebugTrace("DEF-thigh.R", debugFrame, currentAnimation, model);
-            dumpBoneDebugTrace("DEF-thigh.L", debugFrame, currentAnimation, model);
-            dumpBoneDebugTrace("DEF-pelvis", debugFrame, currentAnimation, model);
+            dumpBoneDebugTrace("DEF-thigh.R", debugFrame, playback.clip.get(), model);
+            dumpBoneDebugTrace("DEF-thigh.L", debugFrame, playback.clip.get(), model);
+            dumpBoneDebugTrace("DEF-pelvis", debugFrame, playback.clip.get(), model);
             break;
         }
     }
 
-    for (const auto& [boneName, globalScaled] : globalBoneMatrices)
-    {
-        glm::mat4 offsetMatrix = model->getBoneOffsetMatrix(boneName);
-        glm::mat4 final = model->getGlobalInverseTransform() * globalScaled * offsetMatrix;
-
-        if (boneName == "thigh.R" && debugFrame >= 0)
-        {
-            glm::vec3 pos = glm::vec3(final[3]);
-            Logger::log("DEBUG: Frame " + std::to_string(debugFrame) +
-                " | thigh.R Final Skin Pos: " + glm::to_string(pos),
-                Logger::WARNING);
-        }
-
-        if (boneName == "thigh.L" && debugFrame >= 0)
-        {
-            glm::vec3 pos = glm::vec3(final[3]);
-            Logger::log("DEBUG: Frame " + std::to_string(debugFrame) +
-                " | thigh.L Final Skin Pos: " + glm::to_string(pos),
-                Logger::WARNING);
-        }
+    model->updateSkinPalette(globalPose, boneCount);
 
-        if (shouldDump)
+    if (shouldDump)
+    {
+        const std::vector<glm::mat4>& palette = model->getFinalBoneMatrices();
+        for (size_t i = 0; i < boneCount; ++i)
         {
+            const glm::mat4& globalScaled = globalPose[i];
             glm::mat4 noScale = removeScale(globalScaled);
-            Logger::log("Bone: " + boneName, Logger::WARNING);
+            Logger::log("Bone: " + bones[i].name, Logger::WARNING);
             Logger::log("  Global With Scale:\n" + glm::to_string(globalScaled), Logger::WARNING);
             Logger::log("  Global No Scale:\n" + glm::to_string(noScale), Logger::WARNING);
-            Logger::log("  Final Skin Matrix:\n" + glm::to_string(final), Logger::WARNING);
-        }
-
-        model->setBoneTransform(boneName, final);
-    }
-
-    // === Dump full pose JSON once per animation ===
-    if (currentAnimation && model)
-    {
-        static std::unordered_set<std::string> dumpedAnimations;
-        const std::string animName = currentAnimation->getName();
-
-        if (!dumpedAnimations.count(animName))
-        {
-            currentAnimation->dumpEnginePoseAllFramesJSON("");
-            dumpedAnimations.insert(animName);
+            Logger::log("  Final Skin Matrix:\n" + glm::to_string(palette[i]), Logger::WARNING);
         }
     }
-
 }
 
 
 
 
+// Name-keyed variant for the debug dumps. The first call resolves the
+// whole skeleton in one Model::computeGlobalPose pass (bones without a
+// local use their bind pose); later calls are cache hits.
 glm::mat4 AnimationController::buildGlobalTransform(
     const std::string& boneName,
     const std::map<std::string, glm::mat4>& localBoneMatrices,
@@ -441,29 +729,32 @@ glm::mat4 AnimationController::buildGlobalTransform(
 )
 {
     // Already computed?
-    if (globalBoneMatrices.find(boneName) != globalBoneMatrices.end())
-        return globalBoneMatrices[boneName];
+    auto cached = globalBoneMatrices.find(boneName);
+    if (cached != globalBoneMatrices.end())
+        return cached->second;
 
-    // Get parent's global transform
-    glm::mat4 parentGlobal = glm::mat4(1.0f);
-    std::string parentName = model->getBoneParent(boneName);
-    if (!parentName.empty())
-        parentGlobal = buildGlobalTransform(parentName, localBoneMatrices, model, globalBoneMatrices);
+    FrameArena::Scope scratch(FrameArena::forThisThread());
+    const std::vector<Bone>& bones = model->getBones();
+    glm::mat4* localPose = FrameArena::forThisThread().allocateArray<glm::mat4>(bones.size());
+    glm::mat4* globalPose = FrameArena::forThisThread().allocateArray<glm::mat4>(bones.size());
 
-    // Get animated local transform if available
-    glm::mat4 animatedLocal = glm::mat4(1.0f);
-    auto it = localBoneMatrices.find(boneName);
-    if (it != localBoneMatrices.end())
-        animatedLocal = it->second;
-    else
-        animatedLocal = model->getLocalBindPose(boneName);  // fallback to bind pose local if no animation!
+    const std::vector<glm::mat4>& bindPoses = model->getLocalBindPoses();
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        auto it = localBoneMatrices.find(bones[i].name);
+        localPose[i] = (it != localBoneMatrices.end()) ? it->second : bindPoses[i];
+    }
 
-    // Build global transform
-    glm::mat4 globalTransform = parentGlobal * animatedLocal;
+    model->computeGlobalPose(localPose, globalPose);
+    for (size_t i = 0; i < bones.size(); ++i)
+        globalBoneMatrices.emplace(bones[i].name, globalPose[i]);
 
-    // Cache
-    globalBoneMatrices[boneName] = globalTransform;
-    return globalTransform;
+    // Not a skinned bone: no parent, global is its local
+    cached = globalBoneMatrices.find(boneName);
+    if (cached != globalBoneMatrices.end())
+        return cached->second;
+    auto local = localBoneMatrices.find(boneName);
+    return (local != localBoneMatrices.end()) ? local->second : model->getLocalBindPose(boneName);
 }
 
 
@@ -471,19 +762,20 @@ glm::mat4 AnimationController::buildGlobalTransform(
 
 bool AnimationController::isAnimationPlaying() const
 {
-    return currentAnimation != nullptr;
+    return playback.clip != nullptr;
 }
 
 void AnimationController::stopAnimation()
 {
-    currentAnimation = nullptr;
-    animationTime = 0.0f;
+    playback.clip = nullptr;
+    playback.time = 0.0f;
+    playback.timeAccumulator = 0.0f;
     Logger::log("Animation stopped.", Logger::INFO);
 }
 
 void AnimationController::resetAnimation()
 {
-    animationTime = 0.0f;
+    playback.time = 0.0f;
 }
 
 
@@ -511,21 +803,20 @@ static void dumpBoneDebugTrace(
 {
     if (!animation || !model) return;
 
-    const auto& keyframes = animation->getKeyframes();
-    if (frame < 0 || frame >= static_cast<int>(keyframes.size())) return;
+    if (frame < 0 || frame >= static_cast<int>(animation->getKeyframeCount())) return;
 
-    const auto& kf = keyframes[frame];
+    const Keyframe kf = animation->getKeyframe(frame);
     glm::mat4 localMatrix;
     auto it = kf.boneTransforms.find(boneName);
     if (it != kf.boneTransforms.end())
-        localMatrix = it->second;
+        localMatrix = it->second.toMatrix();
     else
         localMatrix = model->getLocalBindPose(boneName);
 
     // Build full local matrix map
     std::map<std::string, glm::mat4> localBoneMatrices;
-    for (const auto& [name, mat] : kf.boneTransforms)
-        localBoneMatrices[name] = mat;
+    for (const auto& [name, key] : kf.boneTransforms)
+        localBoneMatrices[name] = key.toMatrix();
 
     for (const auto& bone : model->getBones())
         if (!localBoneMatrices.count(bone.name))
@@ -554,33 +845,44 @@ static void dumpBoneDebugTrace(
     Logger::log("Final Skin Matrix:\n" + glm::to_string(skinMatrix), Logger::WARNING);
 }
 
+static std::ofstream& enginePoseDump()
+{
+    static std::ofstream out("logs/pose_dump_engine_Jab_Head.log");
+    return out;
+}
+
+// One "bone": [[...], ...] entry of a dumped frame; DEF- bones only
+static void writePoseDumpBone(std::ostream& out, bool& first,
+    const std::string& boneName, const glm::mat4& mat)
+{
+    if (boneName.rfind("DEF-", 0) != 0)
+        return;
+
+    if (!first) out << ",\n";
+    first = false;
+
+    out << "  \"" << boneName << "\": [\n";
+    for (int i = 0; i < 4; ++i)
+    {
+        out << "    [" << mat[i][0] << ", " << mat[i][1] << ", "
+            << mat[i][2] << ", " << mat[i][3] << "]";
+        if (i < 3) out << ",\n";
+    }
+    out << "\n  ]";
+}
+
 void AnimationController::dumpEnginePoseFrame(
     int frameIdx,
     const std::map<std::string, glm::mat4>& globalBoneMatrices)
 {
-    static std::ofstream out("logs/pose_dump_engine_Jab_Head.log");
+    std::ofstream& out = enginePoseDump();
     if (!out.is_open()) return;
 
     out << "\"" << frameIdx << "\": {\n";
 
     bool first = true;
     for (const auto& [boneName, mat] : globalBoneMatrices)
-    {
-        if (boneName.rfind("DEF-", 0) != 0)
-            continue;
-
-        if (!first) out << ",\n";
-        first = false;
-
-        out << "  \"" << boneName << "\": [\n";
-        for (int i = 0; i < 4; ++i)
-        {
-            out << "    [" << mat[i][0] << ", " << mat[i][1] << ", "
-                << mat[i][2] << ", " << mat[i][3] << "]";
-            if (i < 3) out << ",\n";
-        }
-        out << "\n  ]";
-    }
+        writePoseDumpBone(out, first, boneName, mat);
 
     out << "\n},\n";
 }
@@ -588,27 +890,33 @@ void AnimationController::dumpEnginePoseFrame(
 
 void AnimationController::dumpEnginePoseFrame(int frameIdx)
 {
-    if (!currentAnimation || !model) return;
+    if (!playback.clip || !model) return;
 
-    const auto& keyframes = currentAnimation->getKeyframes();
-    if (frameIdx < 0 || frameIdx >= static_cast<int>(keyframes.size())) return;
+    if (frameIdx < 0 || frameIdx >= static_cast<int>(playback.clip->getKeyframeCount())) return;
 
-    // 1. Extract local bone transforms for this frame
-    const Keyframe& kf = keyframes[frameIdx];
-    std::map<std::string, glm::mat4> localBoneMatrices;
-    for (const auto& [boneName, mat] : kf.boneTransforms)
-        localBoneMatrices[boneName] = mat;
+    std::ofstream& out = enginePoseDump();
+    if (!out.is_open()) return;
 
-    for (const auto& bone : model->getBones())
-        if (!localBoneMatrices.count(bone.name))
-            localBoneMatrices[bone.name] = model->getLocalBindPose(bone.name);
+    // 1. Local pose of this key over the bind pose, bone-indexed scratch
+    FrameArena::Scope scratch(frameArena);
+    const std::vector<Bone>& bones = model->getBones();
+    glm::mat4* localPose = frameArena.allocateArray<glm::mat4>(std::max(bones.size(), playback.clip->getTrackCount()));
+    glm::mat4* globalPose = frameArena.allocateArray<glm::mat4>(bones.size());
 
-    // 2. Reconstruct global bone transforms
-    std::map<std::string, glm::mat4> globalBoneMatrices;
-    for (const auto& [boneName, _] : localBoneMatrices)
-        globalBoneMatrices[boneName] = buildGlobalTransform(boneName, localBoneMatrices, model, globalBoneMatrices);
+    const std::vector<glm::mat4>& bindPoses = model->getLocalBindPoses();
+    std::copy(bindPoses.begin(), bindPoses.end(), localPose);
+    playback.clip->getKeyPose(static_cast<size_t>(frameIdx), localPose);
+
+    // 2. Global transforms in one pass, parents first
+    model->computeGlobalPose(localPose, globalPose);
 
     // 3. Dump them
-    dumpEnginePoseFrame(frameIdx, globalBoneMatrices);
+    out << "\"" << frameIdx << "\": {\n";
+
+    bool first = true;
+    for (size_t i = 0; i < bones.size(); ++i)
+        writePoseDumpBone(out, first, bones[i].name, globalPose[i]);
+
+    out << "\n},\n";
 }
 
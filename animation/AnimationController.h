@@ -2,51 +2,120 @@
 #ifndef ANIMATIONCONTROLLER_H
 #define ANIMATIONCONTROLLER_H
 
+#include <atomic>
+#include <future>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <map>
 #include <vector>
+#include <utility>
 #include <glm/glm.hpp>
 #include "../model/Model.h"
 #include "Animation.h"
 #include "SkeletonPose.h"
+#include "SkinPaletteTable.h"
+#include "ClipLibrary.h"
+#include "../common_utils/FrameArena.h"
+
+/* A clip requested with AnimationController::requestAnimation. The
+   import and bake run on the thread pool; the controller registers the
+   clip (and swaps to it if asked) at the start of its next update().  */
+struct AnimationLoadRequest
+{
+    enum class Status { Loading, Ready, Failed };
+
+    std::string name;
+    std::string filePath;
+    std::atomic<Status> status{ Status::Loading };
+
+    bool isDone() const { return status.load() != Status::Loading; }
+    bool succeeded() const { return status.load() == Status::Ready; }
+
+private:
+    friend class AnimationController;
+    std::shared_ptr<Animation> clip;    /* written by the loader, then baked is set */
+    std::shared_ptr<const SkinPaletteTable> palettes;  /* bakeSkinPalettes: built by the loader too */
+    std::atomic<bool> baked{ false };
+    std::future<void> task;
+};
+
+using AnimationLoadHandle = std::shared_ptr<AnimationLoadRequest>;
+
+/* Everything one character needs to play a clip. The clip itself is a
+   shared asset (ClipLibrary) and is only read during playback.        */
+struct AnimationPlayback
+{
+    std::shared_ptr<const Animation> clip;
+    float time = 0.0f;                  /* ticks; update() snaps it to a key */
+    float timeAccumulator = 0.0f;       /* seconds not yet turned into frames */
+    SampleCursor cursor;                /* segment search state for clip */
+    uint32_t tracedFrames = 0;          /* debug frames 51-59 already traced, one bit each */
+};
 
 class AnimationController {
 public:
     explicit AnimationController(Model* model);
+    ~AnimationController();
 
     bool loadAnimation(const std::string& name,
         const std::string& filePath,
         bool forceReload = false);
 
+    // Loads (name, path) pairs in parallel; registration keeps list order
+    size_t loadAnimations(const std::vector<std::pair<std::string, std::string>>& clips,
+        bool forceReload = false);
+
+    // Non-blocking load: the current clip keeps playing and, with
+    // playWhenReady, the new one takes over at a frame boundary
+    AnimationLoadHandle requestAnimation(const std::string& name,
+        const std::string& filePath,
+        bool playWhenReady = true);
+    bool isLoading(const std::string& name) const;
+
+    // Binds other's clips under the same names, for another character on
+    // the same skeleton; the load-time checks already ran for other
+    bool shareClips(const AnimationController& other);
+
     void setCurrentAnimation(const std::string& name);
 
+    // update() marks the frame boundary: it releases the previous
+    // frame's arena scratch, so call it once per frame before applyToModel
     void update(float deltaTime);
     void applyToModel(Model* model);
 
+    // applyToModel without touching the model: the skin palette for the
+    // controller's model, valid until the next update(). Controllers
+    // sharing a model can evaluate at the same time (AnimationWorld);
+    // draw with Model::useSkinPalette. nullptr when nothing is playing.
+    const glm::mat4* evaluate();
+
+    // Heap allocations on this thread from the start of the last update()
+    // to the end of the following applyToModel(); 0 in steady playback
+    uint64_t getFrameAllocationCount() const { return lastFrameAllocations; }
+    const FrameArena& getFrameArena() const { return frameArena; }
+
     bool isAnimationPlaying() const;
     void stopAnimation();
     void resetAnimation();
 
-    const std::unordered_map<std::string, Animation*>& getAllAnimations() const {
+    const std::unordered_map<std::string, std::shared_ptr<Animation>>& getAllAnimations() const {
         return animations;
     }
 
+    Model* getModel() const { return model; }
+
     bool isClipLoaded(const std::string& name) const {
         return animations.find(name) != animations.end();
     }
 
-    const std::vector<Keyframe>& getKeyframes() const {
-        return currentAnimation ? currentAnimation->getKeyframes() : emptyKeyframeList;
-    }
-
     const std::string& getCurrentAnimationName() const {
         static std::string none = "None";
-        return currentAnimation ? currentAnimation->getName() : none;
+        return playback.clip ? playback.clip->getName() : none;
     }
 
     int getFrameCount() const {
-        return currentAnimation ? static_cast<int>(currentAnimation->getKeyframes().size()) : 0;
+        return playback.clip ? static_cast<int>(playback.clip->getKeyframeCount()) : 0;
     }
 
     // Debug playback flags
@@ -56,6 +125,17 @@ public:
     int debugFrame = 0;
     bool loopPlayback = false;
 
+    const AnimationPlayback& getPlayback() const { return playback; }
+
+    // Quantisation applied to clips loaded from now on
+    CompressionSettings compressionSettings;
+
+    // Precompute every key's skin palette when a clip is loaded;
+    // playback then just points the model at the current key's row.
+    // Playback only ever lands on baked keys (update() snaps to them),
+    // so the result is the same as the per-frame path.
+    bool bakeSkinPalettes = false;
+
     static glm::mat4 buildGlobalTransform(
         const std::string& boneName,
         const std::map<std::string, glm::mat4>& localBoneMatrices,
@@ -69,20 +149,44 @@ public:
     void dumpEnginePoseAllFramesJSON(const std::string& outputPath) const;
 
 private:
+    void registerClip(const std::string& name, std::shared_ptr<Animation> clip,
+        std::shared_ptr<const SkinPaletteTable> palettes = nullptr);
+    void finishPendingLoads();
+
+    // Sample and build the global pose of target, in frame-arena scratch
+    const glm::mat4* sampleGlobalPose(const Model& target);
+
+    // Sample, build the global pose and skin it into the model's palette
+    void applySampledPose(Model* model);
+
+    // The current clip's palette table for target, shared through the
+    // ClipLibrary and rebuilt after batch smoothing; nullptr when not
+    // baking. showing: target may be drawing from the old table.
+    const SkinPaletteTable* bakedPaletteFor(Model* target, bool showing);
+
     Model* model;
-    std::unordered_map<std::string, Animation*> animations;
-    Animation* currentAnimation = nullptr;
-
-    float animationTime = 0.0f;
-    float playbackTime = 0.0f;
-    bool paused = false;
-    bool hasDumpedThisRun = false;
-    int dumpFrameIndex = 0;
-    int currentClipIndex = 0;
+
+    // Clips are ClipLibrary assets; the names are this controller's
+    std::unordered_map<std::string, std::shared_ptr<Animation>> animations;
+    AnimationPlayback playback;
     bool lockToExactFrame = false;
 
+    // Precomputed palettes of the clips played so far (bakeSkinPalettes)
+    std::unordered_map<const Animation*, std::shared_ptr<const SkinPaletteTable>> skinPalettes;
+
+    // evaluate()'s output when the pose is sampled live
+    std::vector<glm::mat4> skinPalette;
+
+    // Background loads, oldest first; finished ones are picked up in update()
+    std::vector<AnimationLoadHandle> pendingLoads;
+    std::string playWhenLoaded;     /* latest clip asked to play once ready */
+
+    // Per-frame pose scratch (bone-indexed arrays), reset by update()
+    FrameArena frameArena;
+    uint64_t frameAllocationStart = 0;
+    uint64_t lastFrameAllocations = 0;
+
     const glm::mat4& bindGlobalNoScale(const std::string& bone) const;
-    inline static const std::vector<Keyframe> emptyKeyframeList = {};
 };
 
 #endif // ANIMATIONCONTROLLER_H
@@ -0,0 +1,71 @@
+// AnimationWorld.cpp
+#include "AnimationWorld.h"
+#include "../common_utils/ThreadPool.h"
+
+#include <chrono>
+
+AnimationWorld::AnimationWorld(unsigned threadCount)
+{
+    setThreadCount(threadCount);
+}
+
+AnimationWorld::~AnimationWorld() = default;
+
+AnimationController& AnimationWorld::addCharacter(Model* model)
+{
+    Character character;
+    character.controller = std::make_unique<AnimationController>(model);
+    character.model = model;
+    characters.push_back(std::move(character));
+    return *characters.back().controller;
+}
+
+void AnimationWorld::clear()
+{
+    characters.clear();
+}
+
+void AnimationWorld::setThreadCount(unsigned count)
+{
+    if (count == threadCount && (count <= 1 || pool))
+        return;
+
+    threadCount = count;
+    pool.reset();
+    if (count > 1)
+        pool = std::make_unique<ThreadPool>(count - 1);
+}
+
+unsigned AnimationWorld::getThreadCount() const
+{
+    if (threadCount == 0)
+        return ThreadPool::shared().getThreadCount() + 1;
+    return threadCount;
+}
+
+void AnimationWorld::update(float deltaTime)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    // A character only touches its own controller and palette; the
+    // models and clips are read-only here
+    auto step = [this, deltaTime](size_t i) {
+        Character& character = characters[i];
+        character.controller->update(deltaTime);
+        character.palette = character.controller->evaluate();
+    };
+
+    if (threadCount == 1)
+    {
+        for (size_t i = 0; i < characters.size(); ++i)
+            step(i);
+    }
+    else
+    {
+        ThreadPool& workers = pool ? *pool : ThreadPool::shared();
+        workers.parallelFor(characters.size(), step);
+    }
+
+    lastUpdateMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
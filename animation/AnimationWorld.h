@@ -0,0 +1,69 @@
+// AnimationWorld.h
+#ifndef ANIMATION_WORLD_H
+#define ANIMATION_WORLD_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "AnimationController.h"
+
+class ThreadPool;
+
+/* Every animated character of a scene. update() advances, samples and
+   skins all of them in parallel and returns once the last one is done:
+   the frame's single sync point, after which the palettes are ready to
+   draw. Characters share clips through the ClipLibrary and may share a
+   Model; each draws with Model::useSkinPalette(getSkinPalette(i)).
+
+   Give characters their clips before adding them to the world's update
+   (loadAnimations, shareClips): requestAnimation hands clips over inside
+   update(), which here runs on the workers.                           */
+class AnimationWorld
+{
+public:
+    // threadCount as for setThreadCount
+    explicit AnimationWorld(unsigned threadCount = 0);
+    ~AnimationWorld();
+
+    AnimationWorld(const AnimationWorld&) = delete;
+    AnimationWorld& operator=(const AnimationWorld&) = delete;
+
+    // A new character playing on model; the world owns its controller
+    AnimationController& addCharacter(Model* model);
+    void clear();
+
+    size_t getCharacterCount() const { return characters.size(); }
+    AnimationController& getController(size_t index) { return *characters[index].controller; }
+    Model* getModel(size_t index) const { return characters[index].model; }
+
+    // Character index's palette from the last update(); nullptr if it
+    // has nothing playing
+    const glm::mat4* getSkinPalette(size_t index) const { return characters[index].palette; }
+
+    void update(float deltaTime);
+
+    // 0: the shared pool; 1: on the calling thread; n: n - 1 workers
+    // of the world's own plus the calling thread
+    void setThreadCount(unsigned threadCount);
+    unsigned getThreadCount() const;            /* threads update() runs on */
+    unsigned getThreadSetting() const { return threadCount; }  /* as passed to setThreadCount */
+
+    // Wall time of the last update(), in milliseconds
+    double getLastUpdateMs() const { return lastUpdateMs; }
+
+private:
+    struct Character
+    {
+        std::unique_ptr<AnimationController> controller;
+        Model* model = nullptr;
+        const glm::mat4* palette = nullptr;
+    };
+
+    std::vector<Character> characters;
+    unsigned threadCount = 0;
+    std::unique_ptr<ThreadPool> pool;       /* threadCount > 1 */
+    double lastUpdateMs = 0.0;
+};
+
+#endif // ANIMATION_WORLD_H
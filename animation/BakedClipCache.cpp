@@ -0,0 +1,411 @@
+// BakedClipCache.cpp
+#include "BakedClipCache.h"
+#include "Animation.h"
+#include "../model/Model.h"
+#include "../common_utils/Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+bool BakedClipCache::enabled = true;
+
+namespace {
+
+    constexpr char     kMagic[4] = { 'O', 'E', 'B', 'C' };
+    constexpr uint32_t kFormatVersion = 3;
+    constexpr size_t   kFloatsPerKey = 10;      /* T xyz, R wxyz, S xyz */
+
+    /* File layout, native endianness:
+         FileHeader
+         bone names     nameBytes, each '\0' terminated
+         key times      frameCount floats
+         keys           frameCount * boneCount * kFloatsPerKey floats,
+                        frame-major, bones in name-table order
+         jitter events  eventCount JitterEvents, bone = name-table index,
+                        clip unused
+         pre-smooth     rawBoneCount uint32 name-table indices, then
+                        rawBoneCount * rawFrameCount * kFloatsPerKey
+                        floats, bone-major                              */
+    struct FileHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint64_t key;
+        float    durationTicks;
+        float    ticksPerSecond;
+        float    clipDurationSecs;
+        uint32_t frameCount;
+        uint32_t boneCount;
+        uint32_t nameBytes;
+        uint32_t eventCount;
+        uint32_t rawBoneCount;
+        uint32_t rawFrameCount;
+    };
+
+    /* -------- FNV-1a, 64 bit -------------------------------------- */
+    constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+    constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+    void hashBytes(uint64_t& h, const void* data, size_t size)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            h ^= p[i];
+            h *= kFnvPrime;
+        }
+    }
+
+    template <typename T>
+    void hashValue(uint64_t& h, const T& v) { hashBytes(h, &v, sizeof(T)); }
+
+    // Hashes the file contents plus its length; a missing file hashes
+    // differently from an empty one
+    void hashFile(uint64_t& h, const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            hashValue(h, uint64_t(~0ull));
+            return;
+        }
+
+        char buffer[1 << 16];
+        uint64_t total = 0;
+        while (in)
+        {
+            in.read(buffer, sizeof(buffer));
+            std::streamsize n = in.gcount();
+            hashBytes(h, buffer, static_cast<size_t>(n));
+            total += static_cast<uint64_t>(n);
+        }
+        hashValue(h, total);
+    }
+
+    // Bone names and local bind poses; also names the entry, so clips
+    // baked for different skeletons keep separate files
+    void hashSkeleton(uint64_t& h, const Model* model)
+    {
+        if (!model)
+            return;
+
+        const std::vector<Bone>& bones = model->getBones();
+        const std::vector<glm::mat4>& bind = model->getLocalBindPoses();
+        for (size_t i = 0; i < bones.size(); ++i)
+        {
+            hashBytes(h, bones[i].name.data(), bones[i].name.size() + 1);
+            if (i < bind.size())
+                hashValue(h, bind[i]);
+        }
+    }
+
+    // Each save writes its own temp file: the same clip can be baked on
+    // several threads at once (one per compression setting, say)
+    std::atomic<uint32_t> tempFileCounter{ 0 };
+
+} // namespace
+
+
+uint64_t BakedClipCache::computeKey(const std::string& fbxPath,
+    const Model* model,
+    const BakeParams& params)
+{
+    uint64_t h = kFnvOffset;
+    hashValue(h, kFormatVersion);
+    hashValue(h, params.frameRate);
+    hashValue(h, params.pipelineVersion);
+    for (const JitterProfile& profile : params.postBakeProfiles)
+    {
+        hashValue(h, profile.t);
+        hashValue(h, profile.rDeg);
+        hashValue(h, profile.window);
+    }
+
+    hashFile(h, fbxPath);
+    hashSkeleton(h, model);
+    return h;
+}
+
+std::string BakedClipCache::pathFor(const std::string& fbxPath, const Model* model)
+{
+    // Same flattening as the per-clip smoothing logs
+    std::string sanitized = fbxPath;
+    std::replace(sanitized.begin(), sanitized.end(), '/', '_');
+    std::replace(sanitized.begin(), sanitized.end(), '\\', '_');
+    std::replace(sanitized.begin(), sanitized.end(), ':', '_');
+
+    uint64_t skeleton = kFnvOffset;
+    hashSkeleton(skeleton, model);
+    char suffix[24];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx.bake", static_cast<unsigned long long>(skeleton));
+    return "cache/animations/" + sanitized + suffix;
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Load: one read of the whole file, then unpack                 */
+/* -------------------------------------------------------------- */
+bool BakedClipCache::load(const std::string& fbxPath, const Model* model, uint64_t key, BakedClip& out)
+{
+    if (!enabled)
+        return false;
+
+    const std::string path = pathFor(fbxPath, model);
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+
+    const std::streamsize size = in.tellg();
+    if (size < static_cast<std::streamsize>(sizeof(FileHeader)))
+        return false;
+
+    std::vector<char> bytes(static_cast<size_t>(size));
+    in.seekg(0);
+    if (!in.read(bytes.data(), size))
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kFormatVersion)
+    {
+        Logger::log("[CACHE] Unrecognised cache file " + path + ", rebaking", Logger::WARNING);
+        return false;
+    }
+    if (header.key != key)
+    {
+        Logger::log("[CACHE] Stale entry for " + fbxPath + ", rebaking", Logger::INFO);
+        return false;
+    }
+
+    const size_t keyFloats = size_t(header.frameCount) * header.boneCount * kFloatsPerKey;
+    const size_t expected = sizeof(FileHeader) + header.nameBytes +
+        (size_t(header.frameCount) + keyFloats) * sizeof(float) +
+        size_t(header.eventCount) * sizeof(JitterEvent) +
+        size_t(header.rawBoneCount) * sizeof(uint32_t) +
+        size_t(header.rawBoneCount) * header.rawFrameCount * kFloatsPerKey * sizeof(float);
+    if (static_cast<size_t>(size) != expected)
+    {
+        Logger::log("[CACHE] Truncated cache file " + path + ", rebaking", Logger::WARNING);
+        return false;
+    }
+
+    const char* cursor = bytes.data() + sizeof(FileHeader);
+
+    std::vector<std::string> boneNames;
+    boneNames.reserve(header.boneCount);
+    const char* namesEnd = cursor + header.nameBytes;
+    while (cursor < namesEnd)
+    {
+        const char* end = static_cast<const char*>(std::memchr(cursor, '\0', namesEnd - cursor));
+        if (!end)
+            return false;
+        boneNames.emplace_back(cursor, end);
+        cursor = end + 1;
+    }
+    if (boneNames.size() != header.boneCount)
+        return false;
+
+    std::vector<float> times(header.frameCount);
+    std::memcpy(times.data(), cursor, times.size() * sizeof(float));
+    cursor += times.size() * sizeof(float);
+
+    out.durationTicks = header.durationTicks;
+    out.ticksPerSecond = header.ticksPerSecond;
+    out.clipDurationSecs = header.clipDurationSecs;
+    out.keyframes.clear();
+    out.keyframes.resize(header.frameCount);
+
+    float v[kFloatsPerKey];
+    for (uint32_t f = 0; f < header.frameCount; ++f)
+    {
+        Keyframe& kf = out.keyframes[f];
+        kf.time = times[f];
+        for (uint32_t b = 0; b < header.boneCount; ++b)
+        {
+            std::memcpy(v, cursor, sizeof(v));
+            cursor += sizeof(v);
+
+            BoneTRS& key = kf.boneTransforms[boneNames[b]];
+            key.translation = glm::vec3(v[0], v[1], v[2]);
+            key.rotation = glm::quat(v[3], v[4], v[5], v[6]);
+            key.scale = glm::vec3(v[7], v[8], v[9]);
+        }
+    }
+
+    // Events come back under this process's trace ids
+    JitterTrace& trace = JitterTrace::shared();
+    const uint16_t clipId = trace.clipId(fbxPath);
+    out.jitterEvents.resize(header.eventCount);
+    std::memcpy(out.jitterEvents.data(), cursor, out.jitterEvents.size() * sizeof(JitterEvent));
+    for (JitterEvent& e : out.jitterEvents)
+    {
+        if (e.bone >= header.boneCount || e.fix >= JitterFix::Count)
+            return false;
+        e.clip = clipId;
+        e.bone = trace.boneId(boneNames[e.bone]);
+    }
+    cursor += out.jitterEvents.size() * sizeof(JitterEvent);
+
+    std::vector<uint32_t> rawBones(header.rawBoneCount);
+    std::memcpy(rawBones.data(), cursor, rawBones.size() * sizeof(uint32_t));
+    cursor += rawBones.size() * sizeof(uint32_t);
+
+    out.preSmoothBones.clear();
+    out.preSmoothKeys.assign(header.rawBoneCount, std::vector<BoneTRS>(header.rawFrameCount));
+    for (uint32_t b = 0; b < header.rawBoneCount; ++b)
+    {
+        if (rawBones[b] >= header.boneCount)
+            return false;
+        out.preSmoothBones.push_back(boneNames[rawBones[b]]);
+        for (BoneTRS& key : out.preSmoothKeys[b])
+        {
+            std::memcpy(v, cursor, sizeof(v));
+            cursor += sizeof(v);
+            key.translation = glm::vec3(v[0], v[1], v[2]);
+            key.rotation = glm::quat(v[3], v[4], v[5], v[6]);
+            key.scale = glm::vec3(v[7], v[8], v[9]);
+        }
+    }
+    return true;
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Save: write to a temp file, then rename over the old entry    */
+/* -------------------------------------------------------------- */
+bool BakedClipCache::save(const std::string& fbxPath, const Model* model, uint64_t key, const BakedClip& clip)
+{
+    if (!enabled || clip.keyframes.empty())
+        return false;
+
+    // The layout needs the same bone set in every frame, which the
+    // forward/reverse fill guarantees; anything else is not cached
+    std::vector<std::string> boneNames;
+    for (const auto& [boneName, _] : clip.keyframes.front().boneTransforms)
+        boneNames.push_back(boneName);
+
+    for (const Keyframe& kf : clip.keyframes)
+    {
+        if (kf.boneTransforms.size() != boneNames.size())
+        {
+            Logger::log("[CACHE] Bone set varies across frames, not caching " + fbxPath, Logger::WARNING);
+            return false;
+        }
+    }
+
+    std::string names;
+    for (const std::string& n : boneNames)
+        names.append(n.c_str(), n.size() + 1);
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.key = key;
+    header.durationTicks = clip.durationTicks;
+    header.ticksPerSecond = clip.ticksPerSecond;
+    header.clipDurationSecs = clip.clipDurationSecs;
+    header.frameCount = static_cast<uint32_t>(clip.keyframes.size());
+    header.boneCount = static_cast<uint32_t>(boneNames.size());
+    header.nameBytes = static_cast<uint32_t>(names.size());
+
+    // Events on bones the bake dropped are not kept
+    std::vector<JitterEvent> events;
+    events.reserve(clip.jitterEvents.size());
+    for (const JitterEvent& e : clip.jitterEvents)
+    {
+        auto it = std::find(boneNames.begin(), boneNames.end(), JitterTrace::shared().getBoneName(e.bone));
+        if (it == boneNames.end())
+            continue;
+        JitterEvent local = e;
+        local.clip = 0;
+        local.bone = static_cast<uint16_t>(it - boneNames.begin());
+        events.push_back(local);
+    }
+    header.eventCount = static_cast<uint32_t>(events.size());
+
+    // Pre-smooth keys of bones the bake dropped are not kept either
+    std::vector<uint32_t> rawBones;
+    std::vector<float> rawKeys;
+    const size_t rawFrames = clip.preSmoothKeys.empty() ? 0 : clip.preSmoothKeys.front().size();
+    for (size_t b = 0; b < clip.preSmoothBones.size() && b < clip.preSmoothKeys.size(); ++b)
+    {
+        auto it = std::find(boneNames.begin(), boneNames.end(), clip.preSmoothBones[b]);
+        if (it == boneNames.end() || clip.preSmoothKeys[b].size() != rawFrames)
+            continue;
+        rawBones.push_back(static_cast<uint32_t>(it - boneNames.begin()));
+        for (const BoneTRS& k : clip.preSmoothKeys[b])
+            rawKeys.insert(rawKeys.end(), {
+                k.translation.x, k.translation.y, k.translation.z,
+                k.rotation.w, k.rotation.x, k.rotation.y, k.rotation.z,
+                k.scale.x, k.scale.y, k.scale.z });
+    }
+    header.rawBoneCount = static_cast<uint32_t>(rawBones.size());
+    header.rawFrameCount = rawBones.empty() ? 0 : static_cast<uint32_t>(rawFrames);
+
+    std::vector<float> payload;
+    payload.reserve(clip.keyframes.size() * (1 + boneNames.size() * kFloatsPerKey));
+    for (const Keyframe& kf : clip.keyframes)
+        payload.push_back(kf.time);
+
+    for (const Keyframe& kf : clip.keyframes)
+    {
+        for (const std::string& boneName : boneNames)
+        {
+            auto it = kf.boneTransforms.find(boneName);
+            if (it == kf.boneTransforms.end())
+            {
+                Logger::log("[CACHE] Bone set varies across frames, not caching " + fbxPath, Logger::WARNING);
+                return false;
+            }
+            const BoneTRS& k = it->second;
+            payload.insert(payload.end(), {
+                k.translation.x, k.translation.y, k.translation.z,
+                k.rotation.w, k.rotation.x, k.rotation.y, k.rotation.z,
+                k.scale.x, k.scale.y, k.scale.z });
+        }
+    }
+
+    const std::string path = pathFor(fbxPath, model);
+    const std::string tmpPath = path + "." + std::to_string(tempFileCounter.fetch_add(1)) + ".tmp";
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    {
+        std::ofstream outFile(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!outFile)
+        {
+            Logger::log("[CACHE] Cannot write " + tmpPath, Logger::WARNING);
+            return false;
+        }
+        outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        outFile.write(names.data(), static_cast<std::streamsize>(names.size()));
+        outFile.write(reinterpret_cast<const char*>(payload.data()),
+            static_cast<std::streamsize>(payload.size() * sizeof(float)));
+        outFile.write(reinterpret_cast<const char*>(events.data()),
+            static_cast<std::streamsize>(events.size() * sizeof(JitterEvent)));
+        outFile.write(reinterpret_cast<const char*>(rawBones.data()),
+            static_cast<std::streamsize>(rawBones.size() * sizeof(uint32_t)));
+        outFile.write(reinterpret_cast<const char*>(rawKeys.data()),
+            static_cast<std::streamsize>(rawKeys.size() * sizeof(float)));
+        if (!outFile)
+        {
+            Logger::log("[CACHE] Write failed for " + tmpPath, Logger::WARNING);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        Logger::log("[CACHE] Cannot replace " + path + ": " + ec.message(), Logger::WARNING);
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+// BakedClipCache.h
+#ifndef BAKED_CLIP_CACHE_H
+#define BAKED_CLIP_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "JitterConfig.h"
+#include "JitterTrace.h"
+
+struct Keyframe;
+struct BoneTRS;
+class Model;
+
+/* Inputs of the bake that are not in the FBX itself. Bump
+   pipelineVersion whenever a pass in Animation::loadAnimation changes. */
+struct BakeParams
+{
+    float    frameRate = 60.0f;
+    uint32_t pipelineVersion = 3;
+
+    /* jitter_config.json resolved for the clip's post-bake targets, in
+       name order: the only part of the config the bake reads */
+    std::vector<JitterProfile> postBakeProfiles;
+};
+
+/* Result of Animation::loadAnimation - everything the constructor
+   needs to skip Assimp, the clamps, the bake and the clean-up passes. */
+struct BakedClip
+{
+    float durationTicks = 0.0f;
+    float ticksPerSecond = 0.0f;
+    float clipDurationSecs = 0.0f;
+    std::vector<Keyframe> keyframes;
+    std::vector<JitterEvent> jitterEvents;   /* clip/bone ids of JitterTrace::shared() */
+    std::vector<std::string> preSmoothBones; /* Animation::getPreSmoothKeys, parallel */
+    std::vector<std::vector<BoneTRS>> preSmoothKeys;
+};
+
+/* On-disk cache of baked clips under cache/animations/. One file per
+   source clip and skeleton, stamped with a hash of the FBX bytes, the bake params
+   (including the clip's resolved jitter profiles) and the skeleton's
+   bind pose (the sanitizer falls back to it); any change to those reads
+   as a miss and the clip is rebaked. Edits to jitter_config.json that
+   leave a clip's profiles alone keep its entry.                      */
+class BakedClipCache
+{
+public:
+    static uint64_t computeKey(const std::string& fbxPath,
+        const Model* model,
+        const BakeParams& params);
+
+    /* the FBX path flattened, plus a hash of model's skeleton */
+    static std::string pathFor(const std::string& fbxPath, const Model* model);
+
+    /* false on a missing, stale or malformed file. Concurrent saves of
+       one entry are safe: each writes its own temp file and renames it
+       over the entry, so the last one wins whole.                    */
+    static bool load(const std::string& fbxPath, const Model* model, uint64_t key, BakedClip& out);
+    static bool save(const std::string& fbxPath, const Model* model, uint64_t key, const BakedClip& clip);
+
+    static void setEnabled(bool on) { enabled = on; }
+    static bool isEnabled() { return enabled; }
+
+private:
+    static bool enabled;
+};
+
+#endif // BAKED_CLIP_CACHE_H
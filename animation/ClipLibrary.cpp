@@ -0,0 +1,206 @@
+// ClipLibrary.cpp
+#include "ClipLibrary.h"
+#include "Animation.h"
+#include "SkinPaletteTable.h"
+#include "../model/Model.h"
+#include "../common_utils/Logger.h"
+
+#include <cstdio>
+
+namespace {
+
+    constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+    constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+    void hashBytes(uint64_t& h, const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            h ^= bytes[i];
+            h *= kFnvPrime;
+        }
+    }
+
+    template <typename T>
+    void hashValue(uint64_t& h, const T& v) { hashBytes(h, &v, sizeof(T)); }
+
+    std::string clipKey(const std::string& filePath, const Model* model, const CompressionSettings& c)
+    {
+        char settings[128];
+        std::snprintf(settings, sizeof(settings), "|%d %g %g %d %g|%016llx",
+            c.enabled ? 1 : 0, c.maxWorldError, c.minBoneReach, c.reduceKeys ? 1 : 0, c.maxReductionError,
+            static_cast<unsigned long long>(model ? ClipLibrary::skeletonSignature(*model) : 0));
+        return filePath + settings;
+    }
+
+} // namespace
+
+
+ClipLibrary& ClipLibrary::shared()
+{
+    static ClipLibrary library;
+    return library;
+}
+
+uint64_t ClipLibrary::skeletonSignature(const Model& model)
+{
+    uint64_t h = kFnvOffset;
+    const std::vector<Bone>& bones = model.getBones();
+    const std::vector<glm::mat4>& bind = model.getLocalBindPoses();
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        hashBytes(h, bones[i].name.data(), bones[i].name.size() + 1);
+        hashValue(h, bones[i].parentIndex);
+        if (i < bind.size())
+            hashValue(h, bind[i]);
+    }
+    return h;
+}
+
+std::shared_ptr<Animation> ClipLibrary::acquire(const std::string& filePath,
+    const Model* model,
+    const CompressionSettings& compression,
+    bool forceReload)
+{
+    const std::string key = clipKey(filePath, model, compression);
+
+    std::promise<std::shared_ptr<Animation>> promise;
+    std::shared_future<std::shared_ptr<Animation>> loading;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!clips.count(key))
+            pruneClips();
+        Entry& entry = clips[key];
+        if (!forceReload)
+        {
+            if (std::shared_ptr<Animation> clip = entry.clip.lock())
+                return clip;
+            if (entry.loading.valid())
+                loading = entry.loading;
+        }
+        if (!loading.valid())
+        {
+            entry.loading = promise.get_future().share();
+            loading = entry.loading;
+            forceReload = true;     // this call does the load
+        }
+    }
+    if (!forceReload)
+        return loading.get();       // someone else is loading it
+
+    std::shared_ptr<Animation> clip;
+    try {
+        clip = std::make_shared<Animation>(filePath, model, compression);
+        if (!clip->isLoaded())
+            clip.reset();
+    }
+    catch (...) {
+        // hand the failure to every waiter, then to our caller
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            clips[key].loading = {};
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry& entry = clips[key];
+        if (clip)
+            entry.clip = clip;
+        entry.loading = {};
+    }
+    promise.set_value(clip);
+    return clip;
+}
+
+std::shared_ptr<const SkinPaletteTable> ClipLibrary::getSkinPalettes(const std::shared_ptr<const Animation>& clip,
+    const Model& model)
+{
+    const std::pair<const Animation*, const Model*> key{ clip.get(), &model };
+
+    std::promise<std::shared_ptr<const SkinPaletteTable>> promise;
+    std::shared_future<std::shared_ptr<const SkinPaletteTable>> building;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!palettes.count(key))
+            prunePalettes();
+        PaletteEntry& entry = palettes[key];
+        if (entry.clip.owner_before(clip) || clip.owner_before(entry.clip))
+        {
+            entry = PaletteEntry{};     // left by a freed clip at the same address
+            entry.clip = clip;
+        }
+        if (std::shared_ptr<const SkinPaletteTable> table = entry.table.lock())
+            if (table->matches(*clip, model))
+                return table;
+        if (entry.building.valid())
+            building = entry.building;
+        else
+            entry.building = promise.get_future().share();
+    }
+    if (building.valid())
+        return building.get();      // characters sharing a model wait for one build
+
+    // The build runs its own parallelFor; the lock stays free meanwhile
+    std::shared_ptr<const SkinPaletteTable> table;
+    try {
+        table = SkinPaletteTable::build(*clip, model);
+    }
+    catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            palettes[key].building = {};
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        PaletteEntry& entry = palettes[key];
+        entry.table = table;
+        entry.building = {};
+    }
+    promise.set_value(table);
+
+    if (table)
+        Logger::log("Baked skin palettes for " + clip->getName() + ": " +
+            std::to_string(table->getFrameCount()) + " frames, " +
+            std::to_string(table->getByteSize() / 1024) + " KB", Logger::INFO);
+    return table;
+}
+
+void ClipLibrary::pruneClips()
+{
+    for (auto it = clips.begin(); it != clips.end(); )
+    {
+        if (it->second.clip.expired() && !it->second.loading.valid())
+            it = clips.erase(it);
+        else
+            ++it;
+    }
+}
+
+void ClipLibrary::prunePalettes()
+{
+    for (auto it = palettes.begin(); it != palettes.end(); )
+    {
+        if (it->second.table.expired() && !it->second.building.valid())
+            it = palettes.erase(it);
+        else
+            ++it;
+    }
+}
+
+size_t ClipLibrary::getClipCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t alive = 0;
+    for (const auto& [key, entry] : clips)
+        if (!entry.clip.expired())
+            ++alive;
+    return alive;
+}
@@ -0,0 +1,84 @@
+// ClipLibrary.h
+#ifndef CLIP_LIBRARY_H
+#define CLIP_LIBRARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "AnimationCompression.h"
+
+class Animation;
+class Model;
+class SkinPaletteTable;
+
+/* Process-wide store of baked clips, shared by every character whose
+   model has the same skeleton (bone names, hierarchy and local bind
+   poses). A clip is loaded once per FBX x skeleton x compression
+   settings and lives while some controller holds it, so memory grows
+   with unique clips, not characters x clips. Playback treats clips as
+   immutable; only the batch tools (smoothing, config reload) modify
+   them, for every holder at once.
+
+   A clip only reads the model while it loads; it keeps its own copy of
+   the bone names, so it may outlive the model that first acquired it.
+   Slots of clips and palettes nobody holds are dropped on insert.    */
+class ClipLibrary
+{
+public:
+    static ClipLibrary& shared();
+
+    /* The clip, loading it on first use; nullptr if the import fails.
+       Thread-safe: concurrent requests for one clip share one load.
+       forceReload builds a fresh clip for later requests; holders of
+       the old one keep it.                                          */
+    std::shared_ptr<Animation> acquire(const std::string& filePath,
+        const Model* model,
+        const CompressionSettings& compression = CompressionSettings{},
+        bool forceReload = false);
+
+    /* Precomputed palettes of clip on model (AnimationController::
+       bakeSkinPalettes), shared by the characters using that model;
+       rebuilt once the clip has been re-smoothed. nullptr if the clip
+       or model has nothing to bake. Built outside the library lock;
+       concurrent requests for one table share one build.            */
+    std::shared_ptr<const SkinPaletteTable> getSkinPalettes(const std::shared_ptr<const Animation>& clip,
+        const Model& model);
+
+    /* Clips acquire() would hand out without loading */
+    size_t getClipCount() const;
+
+    /* Bone names, parents and local bind poses, hashed */
+    static uint64_t skeletonSignature(const Model& model);
+
+private:
+    ClipLibrary() = default;
+
+    struct Entry
+    {
+        std::weak_ptr<Animation> clip;
+        std::shared_future<std::shared_ptr<Animation>> loading;   /* valid while a load runs */
+    };
+
+    struct PaletteEntry
+    {
+        std::weak_ptr<const Animation> clip;    /* the slot's owner; its address may be reused */
+        std::weak_ptr<const SkinPaletteTable> table;
+        std::shared_future<std::shared_ptr<const SkinPaletteTable>> building;   /* valid while a build runs */
+    };
+
+    /* drop the slots of clips and tables nobody holds; under mutex */
+    void pruneClips();
+    void prunePalettes();
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> clips;
+    std::map<std::pair<const Animation*, const Model*>, PaletteEntry> palettes;
+};
+
+#endif // CLIP_LIBRARY_H
@@ -32,16 +32,12 @@ namespace DebugTools {
     void renderBoneHierarchy(Model* model, const Camera& camera) {
         if (!model) return;
 
-        const auto& boneTransforms = model->getBoneTransforms();
         const auto& bones = model->getBones();
         glm::mat4 view = camera.GetViewMatrix();
         glm::mat4 projection = camera.ProjectionMatrix;
 
         for (const auto& bone : bones) {
-            auto it = boneTransforms.find(bone.name);
-            if (it == boneTransforms.end()) continue;
-
-            const glm::mat4& boneWorldTransform = it->second;
+            const glm::mat4& boneWorldTransform = model->getBoneTransform(bone.name);
             glm::vec4 bonePosition = boneWorldTransform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 
             Logger::log("Bone: " + bone.name + " Position: (" +
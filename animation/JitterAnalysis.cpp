@@ -0,0 +1,219 @@
+// JitterAnalysis.cpp
+#include "JitterAnalysis.h"
+#include "Animation.h"
+#include "../common_utils/Logger.h"
+#include "../common_utils/ThreadPool.h"
+#include "../nlohmann/json.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace {
+
+    constexpr size_t kGroupCount = static_cast<size_t>(BoneGroup::Count);
+
+    bool selectsBakedFixes(const JitterFilter& filter)
+    {
+        const uint32_t baked = jitterFixBit(JitterFix::RotArc) | jitterFixBit(JitterFix::DriftLock) |
+            jitterFixBit(JitterFix::PostBakeClamp) | jitterFixBit(JitterFix::PostBakeSmooth);
+        return (filter.fixMask & baked) != 0;
+    }
+
+    // The pre-bake passes walk the source keys, one per tick
+    size_t sourceFrameCount(const Animation& clip)
+    {
+        const float ticks = clip.getClipDurationSeconds() * clip.getTicksPerSecond();
+        return ticks > 0.0f ? static_cast<size_t>(std::lround(ticks)) + 1 : clip.getKeyframeCount();
+    }
+
+    JitterBoneStats analyseBone(const std::string& bone,
+        const std::vector<const JitterEvent*>& events,
+        size_t frameCount)
+    {
+        JitterBoneStats stats;
+        stats.bone = bone;
+        stats.group = JitterTrace::groupOf(bone);
+        stats.hits = events.size();
+
+        std::vector<uint32_t> frames;
+        frames.reserve(events.size());
+        for (const JitterEvent* e : events)
+        {
+            frames.push_back(e->frame);
+            stats.maxTranslationBefore = std::max(stats.maxTranslationBefore, e->translationBefore);
+            stats.maxRotationBeforeDeg = std::max(stats.maxRotationBeforeDeg, e->rotationBeforeDeg);
+        }
+        std::sort(frames.begin(), frames.end());
+        frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+
+        stats.frames = frames.size();
+        stats.rate = frameCount ? float(frames.size()) / float(frameCount) : 0.0f;
+
+        for (uint32_t f : frames)
+        {
+            if (!stats.ranges.empty() && stats.ranges.back().last + 1 == f)
+                stats.ranges.back().last = f;
+            else
+                stats.ranges.push_back({ f, f });
+        }
+        return stats;
+    }
+
+    JitterClipReport analyseClip(const Animation& clip, uint16_t clipId, const JitterFilter& filter)
+    {
+        JitterTrace& trace = JitterTrace::shared();
+
+        JitterFilter clipFilter = filter;
+        clipFilter.clip = clipId;
+        const std::vector<JitterEvent> events = trace.query(clipFilter);
+
+        JitterClipReport report;
+        report.clip = clip.getName();
+        report.frameCount = selectsBakedFixes(filter) ? clip.getKeyframeCount() : sourceFrameCount(clip);
+        for (const JitterEvent& e : events)
+            report.frameCount = std::max<size_t>(report.frameCount, size_t(e.frame) + 1);
+
+        for (size_t g = 0; g < kGroupCount; ++g)
+        {
+            report.groups[g].group = static_cast<BoneGroup>(g);
+            report.heat[g].assign(report.frameCount, 0);
+        }
+        for (const std::string& bone : clip.getAnimatedBones())
+            ++report.groups[static_cast<size_t>(JitterTrace::groupOf(bone))].bones;
+
+        // bucket by bone, in order of first appearance
+        std::unordered_map<uint16_t, size_t> slotOf;
+        std::vector<std::vector<const JitterEvent*>> byBone;
+        std::vector<std::string> boneNames;
+        for (const JitterEvent& e : events)
+        {
+            auto [it, inserted] = slotOf.emplace(e.bone, byBone.size());
+            if (inserted)
+            {
+                byBone.emplace_back();
+                boneNames.push_back(trace.getBoneName(e.bone));
+            }
+            byBone[it->second].push_back(&e);
+        }
+
+        report.bones.resize(byBone.size());
+        ThreadPool::shared().parallelFor(byBone.size(), [&](size_t b) {
+            report.bones[b] = analyseBone(boneNames[b], byBone[b], report.frameCount);
+            });
+
+        std::stable_sort(report.bones.begin(), report.bones.end(),
+            [](const JitterBoneStats& a, const JitterBoneStats& b) { return a.frames > b.frames; });
+
+        for (const JitterBoneStats& bone : report.bones)
+        {
+            const size_t g = static_cast<size_t>(bone.group);
+            JitterGroupStats& group = report.groups[g];
+            group.bonesHit += 1;
+            group.hits += bone.hits;
+            group.frames += bone.frames;
+            for (const JitterFrameRange& range : bone.ranges)
+                for (uint32_t f = range.first; f <= range.last; ++f)
+                    ++report.heat[g][f];
+        }
+        for (JitterGroupStats& group : report.groups)
+        {
+            const size_t cells = std::max(group.bones, group.bonesHit) * report.frameCount;
+            group.rate = cells ? float(group.frames) / float(cells) : 0.0f;
+        }
+        return report;
+    }
+
+} // namespace
+
+
+JitterReport JitterReport::build(const std::vector<const Animation*>& clips,
+    const JitterFilter& filter)
+{
+    std::vector<const Animation*> loaded;
+    std::vector<uint16_t> clipIds;
+    for (const Animation* clip : clips)
+    {
+        if (!clip || !clip->isLoaded())
+            continue;
+        loaded.push_back(clip);
+        clipIds.push_back(JitterTrace::shared().clipId(clip->getName()));
+    }
+
+    JitterReport report;
+    report.clips.resize(loaded.size());
+    ThreadPool::shared().parallelFor(loaded.size(), [&](size_t i) {
+        report.clips[i] = analyseClip(*loaded[i], clipIds[i], filter);
+        });
+    return report;
+}
+
+std::string JitterReport::toJson() const
+{
+    nlohmann::json root;
+    root["clips"] = nlohmann::json::array();
+
+    for (const JitterClipReport& clip : clips)
+    {
+        nlohmann::json jc;
+        jc["clip"] = clip.clip;
+        jc["frames"] = clip.frameCount;
+
+        nlohmann::json bones = nlohmann::json::array();
+        for (const JitterBoneStats& bone : clip.bones)
+        {
+            nlohmann::json ranges = nlohmann::json::array();
+            for (const JitterFrameRange& r : bone.ranges)
+                ranges.push_back({ r.first, r.last });
+
+            bones.push_back({
+                { "bone", bone.bone },
+                { "group", JitterTrace::getGroupName(bone.group) },
+                { "hits", bone.hits },
+                { "frames", bone.frames },
+                { "rate", bone.rate },
+                { "ranges", ranges },
+                { "maxT", bone.maxTranslationBefore },
+                { "maxRDeg", bone.maxRotationBeforeDeg } });
+        }
+        jc["bones"] = bones;
+
+        nlohmann::json groups = nlohmann::json::array();
+        for (const JitterGroupStats& group : clip.groups)
+        {
+            if (group.bones == 0 && group.bonesHit == 0)
+                continue;
+            groups.push_back({
+                { "group", JitterTrace::getGroupName(group.group) },
+                { "bones", group.bones },
+                { "bonesHit", group.bonesHit },
+                { "hits", group.hits },
+                { "frames", group.frames },
+                { "rate", group.rate } });
+        }
+        jc["groups"] = groups;
+
+        root["clips"].push_back(jc);
+    }
+    return root.dump();
+}
+
+bool JitterReport::exportJson(const std::string& path) const
+{
+    std::error_code ec;
+    const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, ec);
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        Logger::log("[JITTER] Cannot write " + path, Logger::WARNING);
+        return false;
+    }
+    out << toJson() << '\n';
+    Logger::log("[JITTER] Wrote " + path, Logger::INFO);
+    return static_cast<bool>(out);
+}
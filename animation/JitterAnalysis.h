@@ -0,0 +1,76 @@
+// JitterAnalysis.h
+#ifndef JITTER_ANALYSIS_H
+#define JITTER_ANALYSIS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "JitterTrace.h"
+
+class Animation;
+
+/* Run of consecutive frames, inclusive */
+struct JitterFrameRange
+{
+    uint32_t first = 0;
+    uint32_t last = 0;
+};
+
+struct JitterBoneStats
+{
+    std::string bone;
+    BoneGroup   group = BoneGroup::Other;
+    size_t      hits = 0;               /* events, repeats included */
+    size_t      frames = 0;             /* distinct frames hit */
+    float       rate = 0.0f;            /* frames / clip frames */
+    std::vector<JitterFrameRange> ranges;
+    float       maxTranslationBefore = 0.0f;
+    float       maxRotationBeforeDeg = 0.0f;
+};
+
+struct JitterGroupStats
+{
+    BoneGroup group = BoneGroup::Other;
+    size_t    bones = 0;                /* the clip's bones in the group */
+    size_t    bonesHit = 0;
+    size_t    hits = 0;
+    size_t    frames = 0;               /* distinct frames, summed over bones */
+    float     rate = 0.0f;              /* frames / (bones * clip frames) */
+};
+
+/* One clip. Frames count source keys when the filter only selects the
+   pre-bake fixes, baked frames otherwise.                              */
+struct JitterClipReport
+{
+    std::string clip;
+    size_t      frameCount = 0;
+    std::vector<JitterBoneStats> bones;                    /* busiest first */
+    JitterGroupStats groups[static_cast<size_t>(BoneGroup::Count)];
+    /* bones hit per frame, one row per group (heatmap) */
+    std::vector<uint16_t> heat[static_cast<size_t>(BoneGroup::Count)];
+};
+
+/* Per-bone and per-group jitter statistics of loaded clips, built from
+   the JitterTrace records their clean-up passes left behind. Replaces
+   jitter_summary.py / jitter_heatmap.py and the text files they wrote
+   to summaries/ and heatmaps/. Clips, and the bones in each clip, are
+   analysed in parallel on the shared thread pool.                     */
+class JitterReport
+{
+public:
+    static JitterReport build(const std::vector<const Animation*>& clips,
+        const JitterFilter& filter = JitterFilter());
+
+    const std::vector<JitterClipReport>& getClips() const { return clips; }
+    bool empty() const { return clips.empty(); }
+
+    /* single-line JSON: clips -> bones (ranges as [first,last]) and groups */
+    std::string toJson() const;
+    bool exportJson(const std::string& path = "logs/jitter_report.json") const;
+
+private:
+    std::vector<JitterClipReport> clips;
+};
+
+#endif // JITTER_ANALYSIS_H
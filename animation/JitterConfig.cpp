@@ -0,0 +1,124 @@
+// JitterConfig.cpp
+#include "JitterConfig.h"
+#include "../common_utils/Logger.h"
+#include "../nlohmann/json.hpp"
+
+#include <fstream>
+
+namespace {
+
+    // Missing fields take the built-in values, as the per-call lookups did
+    std::shared_ptr<const JitterConfig::Table> parseTable(const nlohmann::json& config)
+    {
+        auto table = std::make_shared<JitterConfig::Table>();
+        if (!config.is_object())
+            return table;
+
+        for (const auto& [anim, bones] : config.items())
+        {
+            if (!bones.is_object())
+                continue;
+            for (const auto& [bone, entry] : bones.items())
+            {
+                if (!entry.is_object())
+                    continue;
+                (*table)[anim][bone] = JitterProfile{
+                    entry.value("t", JitterConfig::kDefaultProfile.t),
+                    entry.value("rDeg", JitterConfig::kDefaultProfile.rDeg),
+                    entry.value("window", JitterConfig::kDefaultProfile.window) };
+            }
+        }
+        return table;
+    }
+
+    std::shared_ptr<const JitterConfig::Table> readTable(const char* path)
+    {
+        std::ifstream f(path);
+        if (!f)
+        {
+            Logger::log("WARNING: jitter_config.json not found. Using defaults.", Logger::WARNING);
+            return parseTable(nlohmann::json::object());
+        }
+
+        nlohmann::json parsed = nlohmann::json::parse(f, nullptr, false);
+        if (parsed.is_discarded())
+        {
+            Logger::log("WARNING: jitter_config.json is not valid JSON. Using defaults.", Logger::WARNING);
+            return parseTable(nlohmann::json::object());
+        }
+        return parseTable(parsed);
+    }
+
+} // namespace
+
+
+JitterConfig& JitterConfig::shared()
+{
+    static JitterConfig config;
+    return config;
+}
+
+JitterConfig::JitterConfig()
+{
+    std::error_code ec;
+    writeTime = std::filesystem::last_write_time(kPath, ec);
+    fileSize = std::filesystem::file_size(kPath, ec);
+    table = readTable(kPath);
+}
+
+std::string JitterConfig::clipKey(const std::string& filePath)
+{
+    return std::filesystem::path(filePath).stem().string();
+}
+
+JitterProfile JitterConfig::resolve(const Table& table, const std::string& anim, const std::string& bone)
+{
+    auto find = [&](const std::string& a, const std::string& b) -> const JitterProfile* {
+        auto animIt = table.find(a);
+        if (animIt == table.end())
+            return nullptr;
+        auto boneIt = animIt->second.find(b);
+        return boneIt == animIt->second.end() ? nullptr : &boneIt->second;
+        };
+
+    if (const JitterProfile* p = find(anim, bone)) return *p;
+    if (const JitterProfile* p = find(anim, "*"))  return *p;
+    if (const JitterProfile* p = find("*", bone))  return *p;
+    if (const JitterProfile* p = find("*", "*"))   return *p;
+    return kDefaultProfile;
+}
+
+JitterProfile JitterConfig::resolve(const std::string& anim, const std::string& bone) const
+{
+    return resolve(*getTable(), anim, bone);
+}
+
+std::shared_ptr<const JitterConfig::Table> JitterConfig::getTable() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return table;
+}
+
+bool JitterConfig::reload()
+{
+    std::error_code timeError, sizeError;
+    const auto newTime = std::filesystem::last_write_time(kPath, timeError);
+    const uintmax_t newSize = std::filesystem::file_size(kPath, sizeError);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!timeError && !sizeError && newTime == writeTime && newSize == fileSize)
+            return false;
+        writeTime = newTime;
+        fileSize = newSize;
+    }
+
+    std::shared_ptr<const Table> fresh = readTable(kPath);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (*fresh == *table)
+        return false;
+    table = std::move(fresh);
+    Logger::log("[JITTER] Reloaded jitter_config.json", Logger::INFO);
+    return true;
+}
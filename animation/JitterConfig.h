@@ -0,0 +1,61 @@
+// JitterConfig.h
+#ifndef JITTER_CONFIG_H
+#define JITTER_CONFIG_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/* Post-bake noise clamp thresholds (distance, degrees) and smoothing
+   reach in frames for one bone of one clip */
+struct JitterProfile {
+    float t;
+    float rDeg;
+    int window;
+
+    bool operator==(const JitterProfile& o) const { return t == o.t && rDeg == o.rDeg && window == o.window; }
+    bool operator!=(const JitterProfile& o) const { return !(*this == o); }
+};
+
+/* jitter_config.json, parsed once into a table: anim -> bone ->
+   profile, where "*" stands for any anim or bone. Clips resolve their
+   bones against it when they load (Animation keeps the result); the
+   JSON is not consulted again until reload() picks up a new version.
+   Readers hold a snapshot, so a reload never changes a table that a
+   baking thread is using.                                           */
+class JitterConfig
+{
+public:
+    using Table = std::unordered_map<std::string, std::unordered_map<std::string, JitterProfile>>;
+
+    static constexpr const char* kPath = "jitter_config.json";
+    static constexpr JitterProfile kDefaultProfile{ 0.002f, 0.35f, 2 };
+
+    static JitterConfig& shared();
+
+    /* config key of a clip: "animations/Idle.fbx" -> "Idle" */
+    static std::string clipKey(const std::string& filePath);
+
+    /* anim/bone, anim/"*", "*"/bone, "*"/"*", then kDefaultProfile */
+    static JitterProfile resolve(const Table& table, const std::string& anim, const std::string& bone);
+    JitterProfile resolve(const std::string& anim, const std::string& bone) const;
+
+    std::shared_ptr<const Table> getTable() const;
+
+    /* Re-reads the file when its write time or size changed. True if
+       the profiles in it differ from the current table.             */
+    bool reload();
+
+private:
+    JitterConfig();
+
+    mutable std::mutex mutex;
+    std::shared_ptr<const Table> table;
+    std::filesystem::file_time_type writeTime{};
+    uintmax_t fileSize = 0;
+};
+
+#endif // JITTER_CONFIG_H
@@ -0,0 +1,462 @@
+// JitterTrace.cpp
+#include "JitterTrace.h"
+#include "../common_utils/Logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <thread>
+
+namespace {
+
+    constexpr char     kMagic[4] = { 'O', 'E', 'J', 'T' };
+    constexpr uint32_t kFormatVersion = 1;
+
+    /* File layout, native endianness:
+         FileHeader
+         names      nameBytes: clipCount clip names, then boneCount bone
+                    names, each '\0' terminated (index = id)
+         events     eventCount JitterEvents                              */
+    struct FileHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint32_t clipCount;
+        uint32_t boneCount;
+        uint32_t eventCount;
+        uint32_t nameBytes;
+    };
+
+    void appendNames(std::string& out, const std::vector<std::string>& names)
+    {
+        for (const std::string& n : names)
+            out.append(n.c_str(), n.size() + 1);
+    }
+
+    // Sorted, unique frames of one bone
+    std::vector<uint32_t> uniqueFrames(std::vector<uint32_t> frames)
+    {
+        std::sort(frames.begin(), frames.end());
+        frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+        return frames;
+    }
+
+} // namespace
+
+
+bool JitterFilter::matches(const JitterEvent& e) const
+{
+    return (clip == kAnyClip || e.clip == clip) &&
+        (bone == kAnyBone || e.bone == bone) &&
+        (fixMask & jitterFixBit(e.fix)) != 0 &&
+        e.frame >= firstFrame && e.frame <= lastFrame;
+}
+
+
+// One thread, started by the first saveAsync; at most one save queued
+struct JitterTrace::Saver
+{
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::string queuedPath;
+    bool queued = false;
+    bool busy = false;
+    bool stopping = false;
+    std::thread thread;
+
+    void run(const JitterTrace& trace)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+            wake.wait(lock, [this] { return stopping || queued; });
+            if (!queued)
+                return;             // stopping, nothing left to write
+
+            const std::string path = queuedPath;
+            queued = false;
+            busy = true;
+            lock.unlock();
+
+            trace.save(path);
+
+            lock.lock();
+            busy = false;
+            if (!queued)
+                idle.notify_all();
+        }
+    }
+};
+
+JitterTrace::JitterTrace() : saver(std::make_unique<Saver>()) {}
+
+JitterTrace::~JitterTrace()
+{
+    {
+        std::lock_guard<std::mutex> lock(saver->mutex);
+        saver->stopping = true;
+    }
+    saver->wake.notify_all();
+    if (saver->thread.joinable())
+        saver->thread.join();
+}
+
+JitterTrace& JitterTrace::shared()
+{
+    static JitterTrace trace;
+    return trace;
+}
+
+const char* JitterTrace::getFixName(JitterFix fix)
+{
+    switch (fix) {
+    case JitterFix::HemisphereFlip: return "HEMISPHERE FIX";
+    case JitterFix::RotSpike:       return "FIXED - ROT SPIKE";
+    case JitterFix::PreBakeClamp:   return "PRE-BAKE-CLAMP";
+    case JitterFix::SrtRot:         return "FIXED - SRT+ROT";
+    case JitterFix::RotArc:         return "FIXED - ROT ARC";
+    case JitterFix::DriftLock:      return "DRIFT LOCK";
+    case JitterFix::PostBakeClamp:  return "CLAMPED";
+    case JitterFix::PostBakeSmooth: return "SMOOTHED";
+    default:                        return "UNKNOWN";
+    }
+}
+
+const char* JitterTrace::getGroupName(BoneGroup group)
+{
+    switch (group) {
+    case BoneGroup::Root:      return "root";
+    case BoneGroup::Legs:      return "legs";
+    case BoneGroup::Arms:      return "arms";
+    case BoneGroup::SpineHead: return "spineHead";
+    default:                   return "other";
+    }
+}
+
+BoneGroup JitterTrace::groupOf(const std::string& boneName)
+{
+    static const std::vector<std::pair<BoneGroup, std::vector<const char*>>> groups = {
+        { BoneGroup::Root,      { "root", "pelvis" } },
+        { BoneGroup::Legs,      { "thigh", "shin", "foot", "toe" } },
+        { BoneGroup::Arms,      { "shoulder", "upper_arm", "forearm", "hand" } },
+        { BoneGroup::SpineHead, { "spine", "neck", "head" } },
+    };
+
+    std::string lower = boneName;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    for (const auto& [group, keys] : groups)
+        for (const char* key : keys)
+            if (lower.find(key) != std::string::npos)
+                return group;
+    return BoneGroup::Other;
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Names                                                         */
+/* -------------------------------------------------------------- */
+uint16_t JitterTrace::intern(std::vector<std::string>& names,
+    std::unordered_map<std::string, uint16_t>& ids,
+    const std::string& name)
+{
+    auto it = ids.find(name);
+    if (it != ids.end())
+        return it->second;
+
+    const uint16_t id = static_cast<uint16_t>(names.size());
+    names.push_back(name);
+    ids.emplace(name, id);
+    return id;
+}
+
+uint16_t JitterTrace::clipId(const std::string& clipName)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return intern(clipNames, clipIds, clipName);
+}
+
+uint16_t JitterTrace::boneId(const std::string& boneName)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return intern(boneNames, boneIds, boneName);
+}
+
+std::string JitterTrace::getClipName(uint16_t clip) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return clip < clipNames.size() ? clipNames[clip] : std::string();
+}
+
+std::string JitterTrace::getBoneName(uint16_t bone) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return bone < boneNames.size() ? boneNames[bone] : std::string();
+}
+
+size_t JitterTrace::getClipCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return clipNames.size();
+}
+
+size_t JitterTrace::getBoneCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return boneNames.size();
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Recording                                                     */
+/* -------------------------------------------------------------- */
+void JitterTrace::record(const JitterEvent& event)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back(event);
+}
+
+void JitterTrace::record(const std::vector<JitterEvent>& batch)
+{
+    if (batch.empty())
+        return;
+    std::lock_guard<std::mutex> lock(mutex);
+    events.insert(events.end(), batch.begin(), batch.end());
+}
+
+void JitterTrace::replaceClip(uint16_t clip, const std::vector<JitterEvent>& batch)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    events.erase(std::remove_if(events.begin(), events.end(),
+        [clip](const JitterEvent& e) { return e.clip == clip; }), events.end());
+    events.insert(events.end(), batch.begin(), batch.end());
+}
+
+void JitterTrace::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    events.clear();
+}
+
+size_t JitterTrace::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return events.size();
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Queries                                                       */
+/* -------------------------------------------------------------- */
+std::vector<JitterEvent> JitterTrace::query(const JitterFilter& filter) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<JitterEvent> out;
+    for (const JitterEvent& e : events)
+        if (filter.matches(e))
+            out.push_back(e);
+    return out;
+}
+
+std::vector<JitterBoneSummary> JitterTrace::summarizeBones(const JitterFilter& filter) const
+{
+    // (clip, bone) -> every frame hit, repeats included
+    std::map<std::pair<uint16_t, uint16_t>, std::vector<uint32_t>> hitsByBone;
+    for (const JitterEvent& e : query(filter))
+        hitsByBone[{ e.clip, e.bone }].push_back(e.frame);
+
+    std::vector<JitterBoneSummary> out;
+    out.reserve(hitsByBone.size());
+    for (auto& [key, frames] : hitsByBone)
+    {
+        JitterBoneSummary summary;
+        summary.clip = key.first;
+        summary.bone = key.second;
+        summary.hits = frames.size();
+        summary.frames = uniqueFrames(std::move(frames));
+        out.push_back(std::move(summary));
+    }
+
+    // map order already breaks ties by clip, then bone
+    std::stable_sort(out.begin(), out.end(),
+        [](const JitterBoneSummary& a, const JitterBoneSummary& b) { return a.hits > b.hits; });
+    return out;
+}
+
+std::vector<JitterGroupSummary> JitterTrace::summarizeGroups(const JitterFilter& filter) const
+{
+    const std::vector<JitterBoneSummary> bones = summarizeBones(filter);
+
+    std::map<std::pair<uint16_t, BoneGroup>, JitterGroupSummary> groups;
+    for (const JitterBoneSummary& bone : bones)
+    {
+        const BoneGroup group = groupOf(getBoneName(bone.bone));
+        JitterGroupSummary& summary = groups[{ bone.clip, group }];
+        summary.clip = bone.clip;
+        summary.group = group;
+        summary.bones += 1;
+        summary.frames += bone.frames.size();
+    }
+
+    std::vector<JitterGroupSummary> out;
+    out.reserve(groups.size());
+    for (const auto& [_, summary] : groups)
+        out.push_back(summary);
+    return out;
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Save / load                                                   */
+/* -------------------------------------------------------------- */
+bool JitterTrace::save(const std::string& path) const
+{
+    // Saves share the .tmp path; the snapshot is taken under this too so
+    // the file left behind is the newest
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+
+    std::string names;
+    FileHeader header{};
+    std::vector<JitterEvent> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        appendNames(names, clipNames);
+        appendNames(names, boneNames);
+        header.clipCount = static_cast<uint32_t>(clipNames.size());
+        header.boneCount = static_cast<uint32_t>(boneNames.size());
+        snapshot = events;
+    }
+
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.eventCount = static_cast<uint32_t>(snapshot.size());
+    header.nameBytes = static_cast<uint32_t>(names.size());
+
+    const std::string tmpPath = path + ".tmp";
+    std::error_code ec;
+    const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, ec);
+
+    {
+        std::ofstream outFile(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!outFile)
+        {
+            Logger::log("[TRACE] Cannot write " + tmpPath, Logger::WARNING);
+            return false;
+        }
+        outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        outFile.write(names.data(), static_cast<std::streamsize>(names.size()));
+        outFile.write(reinterpret_cast<const char*>(snapshot.data()),
+            static_cast<std::streamsize>(snapshot.size() * sizeof(JitterEvent)));
+        if (!outFile)
+        {
+            Logger::log("[TRACE] Write failed for " + tmpPath, Logger::WARNING);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        Logger::log("[TRACE] Cannot replace " + path + ": " + ec.message(), Logger::WARNING);
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+void JitterTrace::saveAsync(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(saver->mutex);
+        saver->queuedPath = path;
+        saver->queued = true;
+        if (!saver->thread.joinable())
+            saver->thread = std::thread([this] { saver->run(*this); });
+    }
+    saver->wake.notify_one();
+}
+
+void JitterTrace::waitForSave()
+{
+    std::unique_lock<std::mutex> lock(saver->mutex);
+    saver->idle.wait(lock, [this] { return !saver->queued && !saver->busy; });
+}
+
+bool JitterTrace::load(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+
+    const std::streamsize size = in.tellg();
+    if (size < static_cast<std::streamsize>(sizeof(FileHeader)))
+        return false;
+
+    std::vector<char> bytes(static_cast<size_t>(size));
+    in.seekg(0);
+    if (!in.read(bytes.data(), size))
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kFormatVersion)
+    {
+        Logger::log("[TRACE] Unrecognised trace file " + path, Logger::WARNING);
+        return false;
+    }
+
+    const size_t expected = sizeof(FileHeader) + header.nameBytes +
+        size_t(header.eventCount) * sizeof(JitterEvent);
+    if (static_cast<size_t>(size) != expected)
+    {
+        Logger::log("[TRACE] Truncated trace file " + path, Logger::WARNING);
+        return false;
+    }
+
+    const char* cursor = bytes.data() + sizeof(FileHeader);
+    const char* namesEnd = cursor + header.nameBytes;
+    std::vector<std::string> names;
+    while (cursor < namesEnd)
+    {
+        const char* end = static_cast<const char*>(std::memchr(cursor, '\0', namesEnd - cursor));
+        if (!end)
+            return false;
+        names.emplace_back(cursor, end);
+        cursor = end + 1;
+    }
+    if (names.size() != size_t(header.clipCount) + header.boneCount)
+        return false;
+
+    std::vector<JitterEvent> loadedEvents(header.eventCount);
+    std::memcpy(loadedEvents.data(), cursor, loadedEvents.size() * sizeof(JitterEvent));
+    for (const JitterEvent& e : loadedEvents)
+    {
+        if (e.clip >= header.clipCount || e.bone >= header.boneCount ||
+            e.fix >= JitterFix::Count)
+        {
+            Logger::log("[TRACE] Bad event in " + path, Logger::WARNING);
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    clipNames.assign(names.begin(), names.begin() + header.clipCount);
+    boneNames.assign(names.begin() + header.clipCount, names.end());
+    clipIds.clear();
+    boneIds.clear();
+    for (size_t i = 0; i < clipNames.size(); ++i)
+        clipIds.emplace(clipNames[i], static_cast<uint16_t>(i));
+    for (size_t i = 0; i < boneNames.size(); ++i)
+        boneIds.emplace(boneNames[i], static_cast<uint16_t>(i));
+    events = std::move(loadedEvents);
+    return true;
+}
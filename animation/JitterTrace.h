@@ -0,0 +1,155 @@
+// JitterTrace.h
+#ifndef JITTER_TRACE_H
+#define JITTER_TRACE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Corrections made by the clean-up passes in Animation::loadAnimation
+   and Animation::suppressPostBakeJitter. The pre-bake kinds count
+   frames in the source keys, the rest in the baked 60 FPS frames.      */
+enum class JitterFix : uint8_t
+{
+    HemisphereFlip,     /* pre-bake: rotCurr sign flipped for comparison */
+    RotSpike,           /* pre-bake: lone rotation spike slerped out */
+    PreBakeClamp,       /* pre-bake: translation spike / noise averaged */
+    SrtRot,             /* pre-bake: full key replaced by its neighbours */
+    RotArc,             /* baked: 5-frame rotation arc smoothed */
+    DriftLock,          /* baked: bone locked to its average pose (frame 0) */
+    PostBakeClamp,      /* suppressPostBakeJitter: noise clamped to prev */
+    PostBakeSmooth,     /* suppressPostBakeJitter: cubic window */
+    Count
+};
+
+/* One correction. The deltas are the larger of the steps to the
+   neighbouring keys (distance and degrees), before and after the fix. */
+struct JitterEvent
+{
+    uint16_t clip = 0;          /* JitterTrace::getClipName */
+    uint16_t bone = 0;          /* JitterTrace::getBoneName */
+    uint32_t frame = 0;
+    JitterFix fix = JitterFix::PreBakeClamp;
+    uint8_t  reserved[3] = {};
+    float    translationBefore = 0.0f;
+    float    translationAfter = 0.0f;
+    float    rotationBeforeDeg = 0.0f;
+    float    rotationAfterDeg = 0.0f;
+};
+static_assert(sizeof(JitterEvent) == 28, "JitterEvent is written to disk as is");
+
+constexpr uint32_t jitterFixBit(JitterFix fix) { return 1u << static_cast<uint32_t>(fix); }
+
+/* Buckets of jitter_heatmap.py, matched on the lower-cased bone name
+   in this order                                                        */
+enum class BoneGroup : uint8_t { Root, Legs, Arms, SpineHead, Other, Count };
+
+/* Which events a query looks at. The default fix set is what the
+   scripts counted as suppressed jitter.                              */
+struct JitterFilter
+{
+    static constexpr uint32_t kAnyClip = ~0u;
+    static constexpr uint32_t kAnyBone = ~0u;
+
+    uint32_t clip = kAnyClip;
+    uint32_t bone = kAnyBone;
+    uint32_t fixMask = jitterFixBit(JitterFix::RotSpike) |
+        jitterFixBit(JitterFix::PreBakeClamp) | jitterFixBit(JitterFix::SrtRot);
+    uint32_t firstFrame = 0;
+    uint32_t lastFrame = ~0u;
+
+    bool matches(const JitterEvent& e) const;
+};
+
+/* jitter_summary.py: hits per bone and the distinct frames hit */
+struct JitterBoneSummary
+{
+    uint16_t clip = 0;
+    uint16_t bone = 0;
+    size_t   hits = 0;
+    std::vector<uint32_t> frames;   /* sorted, unique */
+};
+
+/* jitter_heatmap.py group summary: distinct frames summed over the
+   group's bones                                                   */
+struct JitterGroupSummary
+{
+    uint16_t  clip = 0;
+    BoneGroup group = BoneGroup::Other;
+    size_t    bones = 0;
+    size_t    frames = 0;
+};
+
+/* Process-wide record of JitterEvents, replacing the regex scrape of
+   output.txt by jitter_summary.py / jitter_heatmap.py. Clip and bone
+   names are interned once; events refer to them by id. Recording is
+   thread-safe (clips bake on the thread pool); save() writes the whole
+   trace to logs/jitter_trace.bin and load() reads one back.          */
+class JitterTrace
+{
+public:
+    JitterTrace();
+    ~JitterTrace();     /* finishes a queued saveAsync */
+
+    static JitterTrace& shared();
+
+    static constexpr const char* kDefaultPath = "logs/jitter_trace.bin";
+
+    static const char* getFixName(JitterFix fix);
+    static const char* getGroupName(BoneGroup group);
+    static BoneGroup   groupOf(const std::string& boneName);
+
+    /* ids are stable for the life of the trace */
+    uint16_t clipId(const std::string& clipName);
+    uint16_t boneId(const std::string& boneName);
+    std::string getClipName(uint16_t clip) const;
+    std::string getBoneName(uint16_t bone) const;
+    size_t getClipCount() const;
+    size_t getBoneCount() const;
+
+    void record(const JitterEvent& event);
+    void record(const std::vector<JitterEvent>& events);
+    /* a rebaked clip: drops the clip's earlier events first */
+    void replaceClip(uint16_t clip, const std::vector<JitterEvent>& events);
+    void clear();
+
+    size_t size() const;
+    std::vector<JitterEvent> query(const JitterFilter& filter = JitterFilter()) const;
+
+    /* busiest bone first; ties by clip then bone id */
+    std::vector<JitterBoneSummary>  summarizeBones(const JitterFilter& filter = JitterFilter()) const;
+    /* per clip, in BoneGroup order; groups with no hits are left out */
+    std::vector<JitterGroupSummary> summarizeGroups(const JitterFilter& filter = JitterFilter()) const;
+
+    bool save(const std::string& path = kDefaultPath) const;
+    /* save() on a background thread; returns at once. Requests made
+       while one is queued fold into it (it snapshots when it runs).
+       Saves, queued or not, never overlap.                          */
+    void saveAsync(const std::string& path = kDefaultPath);
+    /* blocks until no saveAsync is queued or running */
+    void waitForSave();
+    /* replaces the current contents; false on a missing or malformed file */
+    bool load(const std::string& path);
+
+private:
+    static uint16_t intern(std::vector<std::string>& names,
+        std::unordered_map<std::string, uint16_t>& ids,
+        const std::string& name);
+
+    mutable std::mutex mutex;
+    std::vector<std::string> clipNames;
+    std::vector<std::string> boneNames;
+    std::unordered_map<std::string, uint16_t> clipIds;
+    std::unordered_map<std::string, uint16_t> boneIds;
+    std::vector<JitterEvent> events;
+
+    mutable std::mutex fileMutex;       /* one save() writing at a time */
+    struct Saver;
+    std::unique_ptr<Saver> saver;       /* last: stops before the rest goes */
+};
+
+#endif // JITTER_TRACE_H
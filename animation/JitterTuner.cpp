@@ -0,0 +1,251 @@
+// JitterTuner.cpp
+#include "JitterTuner.h"
+#include "../model/Model.h"
+#include "../common_utils/Logger.h"
+#include "../common_utils/ThreadPool.h"
+#include "../nlohmann/json.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+
+namespace {
+
+    /* Same window and threshold as the drift analysis in loadAnimation */
+    constexpr size_t kDriftWindow = 5;
+    constexpr float  kDriftStdThreshold = 0.003f;
+    constexpr size_t kDriftWeight = 3;
+
+    // 5-frame windows whose positions all stay within the threshold of
+    // their mean
+    size_t countFlatWindows(const std::vector<BoneTRS>& keys)
+    {
+        size_t flat = 0;
+        for (size_t i = 0; i + kDriftWindow <= keys.size(); ++i)
+        {
+            glm::vec3 mean(0.0f);
+            for (size_t j = i; j < i + kDriftWindow; ++j)
+                mean += keys[j].translation;
+            mean /= float(kDriftWindow);
+
+            float maxStd = 0.0f;
+            for (size_t j = i; j < i + kDriftWindow; ++j)
+                maxStd = std::max(maxStd, glm::length(keys[j].translation - mean));
+
+            if (maxStd <= kDriftStdThreshold)
+                ++flat;
+        }
+        return flat;
+    }
+
+    struct Score
+    {
+        size_t hits = 0;
+        size_t drift = 0;
+        size_t total() const { return hits + kDriftWeight * drift; }
+    };
+
+    Score scoreProfile(const std::vector<BoneTRS>& raw, size_t rawFlat, const JitterProfile& profile)
+    {
+        std::vector<BoneTRS> keys = raw;
+        std::vector<BoneTRS*> column(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+            column[i] = &keys[i];
+
+        Score score;
+        score.hits = suppressBoneJitter(column.data(), keys.size(), profile).clamped;
+
+        const size_t flat = countFlatWindows(keys);
+        score.drift = flat > rawFlat ? flat - rawFlat : 0;
+        return score;
+    }
+
+    bool sameProfile(const JitterProfile& a, const JitterProfile& b)
+    {
+        return a.t == b.t && a.rDeg == b.rDeg && a.window == b.window;
+    }
+
+    // Shortest decimal for the config file (0.0015, not 0.00150000001)
+    double configValue(float v)
+    {
+        return std::round(double(v) * 1e6) / 1e6;
+    }
+
+} // namespace
+
+
+std::vector<JitterSweepResult> JitterTuner::sweep(
+    const std::vector<std::pair<std::string, std::string>>& clips,
+    const Model* model,
+    const JitterSweepGrid& grid,
+    const std::vector<std::string>& bones)
+{
+    std::vector<JitterProfile> candidates;
+    for (float t : grid.t)
+        for (float r : grid.rDeg)
+            for (int w : grid.window)
+                candidates.push_back({ t, r, w });
+
+    // One import per clip, keeping the keys the post-bake pass started from
+    std::vector<std::unique_ptr<Animation>> loaded(clips.size());
+    ThreadPool::shared().parallelFor(clips.size(), [&](size_t i) {
+        loaded[i] = std::make_unique<Animation>(clips[i].second, model, CompressionSettings{}, true);
+        });
+
+    // Each tuned bone's unsmoothed keys, copied out once
+    struct Job
+    {
+        size_t clip = 0;
+        std::string bone;
+        std::vector<BoneTRS> keys;
+        size_t flatWindows = 0;
+    };
+    std::vector<Job> jobs;
+
+    for (size_t c = 0; c < clips.size(); ++c)
+    {
+        const Animation& anim = *loaded[c];
+        if (!anim.isLoaded() || anim.getKeyframeCount() == 0)
+        {
+            Logger::log("[TUNE] Skipping " + clips[c].second + " (failed to load)", Logger::WARNING);
+            continue;
+        }
+
+        // Only the post-bake targets read their profiles
+        const std::vector<std::string>& targets = anim.getPreSmoothBones();
+        for (size_t b = 0; b < targets.size(); ++b)
+        {
+            if (!bones.empty() && std::find(bones.begin(), bones.end(), targets[b]) == bones.end())
+                continue;
+
+            Job job;
+            job.clip = c;
+            job.bone = targets[b];
+            job.keys = anim.getPreSmoothKeys()[b];
+            jobs.push_back(std::move(job));
+        }
+    }
+
+    ThreadPool::shared().parallelFor(jobs.size(), [&](size_t j) {
+        jobs[j].flatWindows = countFlatWindows(jobs[j].keys);
+        });
+
+    // Every job x candidate, plus each job under its current profile
+    std::vector<JitterProfile> currentProfiles(jobs.size());
+    for (size_t j = 0; j < jobs.size(); ++j)
+        currentProfiles[j] = loaded[jobs[j].clip]->getProfileFor(clips[jobs[j].clip].first, jobs[j].bone);
+
+    const size_t stride = candidates.size() + 1;
+    std::vector<Score> scores(jobs.size() * stride);
+    ThreadPool::shared().parallelFor(scores.size(), [&](size_t k) {
+        const Job& job = jobs[k / stride];
+        const size_t c = k % stride;
+        const JitterProfile& profile = (c < candidates.size()) ? candidates[c] : currentProfiles[k / stride];
+        scores[k] = scoreProfile(job.keys, job.flatWindows, profile);
+        });
+
+    std::vector<JitterSweepResult> results;
+    results.reserve(jobs.size());
+    for (size_t j = 0; j < jobs.size(); ++j)
+    {
+        const Score* jobScores = &scores[j * stride];
+
+        JitterSweepResult result;
+        result.anim = clips[jobs[j].clip].first;
+        result.bone = jobs[j].bone;
+        result.current = currentProfiles[j];
+        result.currentScore = jobScores[candidates.size()].total();
+
+        size_t bestIndex = candidates.size();     // the current profile
+        size_t bestScore = result.currentScore;
+        for (size_t c = 0; c < candidates.size(); ++c)
+        {
+            if (jobScores[c].total() < bestScore)
+            {
+                bestIndex = c;
+                bestScore = jobScores[c].total();
+            }
+        }
+
+        result.best = (bestIndex < candidates.size()) ? candidates[bestIndex] : result.current;
+        result.hits = jobScores[bestIndex].hits;
+        result.drift = jobScores[bestIndex].drift;
+        result.score = bestScore;
+        results.push_back(result);
+    }
+    return results;
+}
+
+bool JitterTuner::writeConfig(const std::vector<JitterSweepResult>& results, const std::string& path)
+{
+    nlohmann::json config = nlohmann::json::object();
+    {
+        std::ifstream in(path);
+        if (in)
+        {
+            config = nlohmann::json::parse(in, nullptr, false);
+            if (config.is_discarded() || !config.is_object())
+            {
+                Logger::log("[TUNE] " + path + " is not a JSON object, rewriting it", Logger::WARNING);
+                config = nlohmann::json::object();
+            }
+        }
+    }
+
+    size_t changed = 0;
+    for (const JitterSweepResult& result : results)
+    {
+        if (sameProfile(result.best, result.current))
+            continue;
+
+        config[result.anim][result.bone] = {
+            { "t", configValue(result.best.t) },
+            { "rDeg", configValue(result.best.rDeg) },
+            { "window", result.best.window } };
+        ++changed;
+    }
+
+    if (changed == 0)
+    {
+        Logger::log("[TUNE] No profile changes; " + path + " left as is", Logger::INFO);
+        return true;
+    }
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        Logger::log("[TUNE] Cannot write " + path, Logger::ERROR);
+        return false;
+    }
+    out << config.dump(2) << '\n';
+    Logger::log("[TUNE] Wrote " + std::to_string(changed) + " profile(s) to " + path, Logger::INFO);
+    return static_cast<bool>(out);
+}
+
+int JitterTuner::runHeadless(const Model* model)
+{
+    const std::vector<std::pair<std::string, std::string>> clips = {
+        { "Jab_Head", "animations/Jab_Head.fbx" },
+        { "Idle",     "animations/Idle.fbx" },
+        { "Stance1",  "animations/Stance1.fbx" } };
+
+    const std::vector<JitterSweepResult> results = sweep(clips, model);
+    for (const JitterSweepResult& r : results)
+    {
+        Logger::log("[TUNE] " + r.anim + " " + r.bone +
+            ": t=" + std::to_string(r.best.t) +
+            " rDeg=" + std::to_string(r.best.rDeg) +
+            " window=" + std::to_string(r.best.window) +
+            " score=" + std::to_string(r.score) +
+            " (hits " + std::to_string(r.hits) + ", drift " + std::to_string(r.drift) +
+            "; current " + std::to_string(r.currentScore) + ")", Logger::INFO);
+    }
+
+    if (results.empty())
+    {
+        Logger::log("[TUNE] Nothing to tune", Logger::ERROR);
+        return 1;
+    }
+    return writeConfig(results) ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+// JitterTuner.h
+#ifndef JITTER_TUNER_H
+#define JITTER_TUNER_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Animation.h"
+
+class Model;
+
+/* Candidate profiles: every (t, rDeg, window) combination is tried.
+   The defaults are the grid of tune_thresholds.py.                    */
+struct JitterSweepGrid
+{
+    std::vector<float> t{ 0.0015f, 0.0020f, 0.0030f };
+    std::vector<float> rDeg{ 0.25f, 0.35f, 0.50f };
+    std::vector<int>   window{ 2 };
+};
+
+/* Outcome for one clip/bone. score = hits + 3 * drift, lower is better:
+   hits are the frames the noise clamp fired on, drift the 5-frame
+   windows the pass flattened below the drift-analysis threshold.      */
+struct JitterSweepResult
+{
+    std::string   anim;             /* jitter_config.json key, e.g. "Idle" */
+    std::string   bone;
+    JitterProfile current{};        /* what the config resolves to today */
+    size_t        currentScore = 0;
+    JitterProfile best{};
+    size_t        hits = 0;
+    size_t        drift = 0;
+    size_t        score = 0;
+};
+
+/* In-process replacement for tune_thresholds.py, which relaunched the
+   engine once per grid point. Each FBX is imported once; every
+   candidate runs suppressBoneJitter on its own copy of a bone's keys
+   as the post-bake pass received them (Animation::getPreSmoothKeys),
+   all clip x bone x candidate jobs in parallel on the shared thread
+   pool. Only the post-bake target bones are tuned, as only they read
+   their profiles. Ties keep the current profile when it is among them,
+   else the first candidate in grid order.                            */
+class JitterTuner
+{
+public:
+    /* clips: (config name, FBX path) pairs as for loadAnimations;
+       bones: empty for every post-bake target bone, else the
+       targets among these */
+    static std::vector<JitterSweepResult> sweep(
+        const std::vector<std::pair<std::string, std::string>>& clips,
+        const Model* model,
+        const JitterSweepGrid& grid = JitterSweepGrid(),
+        const std::vector<std::string>& bones = {});
+
+    /* Writes each winning profile under config[anim][bone] unless the
+       file already resolves that bone to it; other entries are kept. */
+    static bool writeConfig(const std::vector<JitterSweepResult>& results,
+        const std::string& path = "jitter_config.json");
+
+    /* `OpenEngine --tune-jitter`: sweeps the stock clips with the
+       default grid and writes jitter_config.json. Returns the exit code. */
+    static int runHeadless(const Model* model);
+};
+
+#endif // JITTER_TUNER_H
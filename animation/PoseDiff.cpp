@@ -0,0 +1,347 @@
+// PoseDiff.cpp
+#include "PoseDiff.h"
+#include "PoseDump.h"
+#include "../common_utils/Logger.h"
+#include "../common_utils/MappedFile.h"
+#include "../common_utils/ThreadPool.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define POSE_DIFF_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <unordered_map>
+
+namespace {
+
+    constexpr float kRadToDeg = 57.29577951f;
+
+    /* Translation distance and rotation angle (radians) between two
+       column-major 4x4 matrices. The rotation columns are normalised
+       first, then the angle comes from the Frobenius distance of the
+       rotations, |Ra - Rb|^2 = 8 sin^2(angle / 2), which stays accurate
+       for the tiny angles acos(trace) would lose.                     */
+#if POSE_DIFF_SSE2
+    inline float laneSum3(__m128 v)
+    {
+        alignas(16) float f[4];
+        _mm_store_ps(f, v);
+        return f[0] + f[1] + f[2];
+    }
+
+    inline float lane3(__m128 v)
+    {
+        return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+
+    // [sum(a), sum(b), sum(c), sum(d)]
+    inline __m128 sumEach(__m128 a, __m128 b, __m128 c, __m128 d)
+    {
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        return _mm_add_ps(_mm_add_ps(a, b), _mm_add_ps(c, d));
+    }
+
+    inline __m128 splatLane(__m128 v, int lane)
+    {
+        switch (lane)
+        {
+        case 0:  return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+        case 1:  return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+        default: return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+        }
+    }
+
+    void matrixError(const float* a, const float* b, float& translation, float& angle)
+    {
+        const __m128 xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+        const __m128 tiny = _mm_set1_ps(1e-30f);
+
+        __m128 ca[3], cb[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            ca[i] = _mm_and_ps(_mm_loadu_ps(a + i * 4), xyz);
+            cb[i] = _mm_and_ps(_mm_loadu_ps(b + i * 4), xyz);
+        }
+        const __m128 d = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(a + 12), _mm_loadu_ps(b + 12)), xyz);
+
+        // column lengths of both rotations, |d|^2 in lane 3 of the first
+        const __m128 lenA = sumEach(_mm_mul_ps(ca[0], ca[0]), _mm_mul_ps(ca[1], ca[1]),
+            _mm_mul_ps(ca[2], ca[2]), _mm_mul_ps(d, d));
+        const __m128 lenB = sumEach(_mm_mul_ps(cb[0], cb[0]), _mm_mul_ps(cb[1], cb[1]),
+            _mm_mul_ps(cb[2], cb[2]), _mm_setzero_ps());
+        const __m128 invA = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_max_ps(lenA, tiny)));
+        const __m128 invB = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_max_ps(lenB, tiny)));
+
+        __m128 diff[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            diff[i] = _mm_sub_ps(_mm_mul_ps(ca[i], splatLane(invA, i)), _mm_mul_ps(cb[i], splatLane(invB, i)));
+            diff[i] = _mm_mul_ps(diff[i], diff[i]);
+        }
+        const float frobenius2 = laneSum3(sumEach(diff[0], diff[1], diff[2], _mm_setzero_ps()));
+
+        translation = std::sqrt(lane3(lenA));
+        angle = 2.0f * std::asin(std::min(1.0f, std::sqrt(frobenius2 * 0.125f)));
+    }
+#else
+    void matrixError(const float* a, const float* b, float& translation, float& angle)
+    {
+        float frobenius2 = 0.0f;
+        for (int c = 0; c < 3; ++c)
+        {
+            const float* ca = a + c * 4;
+            const float* cb = b + c * 4;
+            const float invA = 1.0f / std::sqrt(std::max(ca[0] * ca[0] + ca[1] * ca[1] + ca[2] * ca[2], 1e-30f));
+            const float invB = 1.0f / std::sqrt(std::max(cb[0] * cb[0] + cb[1] * cb[1] + cb[2] * cb[2], 1e-30f));
+            for (int r = 0; r < 3; ++r)
+            {
+                const float e = ca[r] * invA - cb[r] * invB;
+                frobenius2 += e * e;
+            }
+        }
+
+        const float dx = a[12] - b[12], dy = a[13] - b[13], dz = a[14] - b[14];
+        translation = std::sqrt(dx * dx + dy * dy + dz * dz);
+        angle = 2.0f * std::asin(std::min(1.0f, std::sqrt(frobenius2 * 0.125f)));
+    }
+#endif
+
+    /* A dump either mapped and read in place (binary) or parsed (JSON) */
+    struct LoadedDump
+    {
+        MappedFile   file;
+        PoseDumpData parsed;
+        PoseDumpView view;
+
+        bool load(const std::string& path)
+        {
+            if (file.open(path) && file.size() >= 4 && std::equal(file.data(), file.data() + 4, "OEPD"))
+                return PoseDump::parse(file.data(), file.size(), view, path);
+
+            file.close();
+            if (!PoseDump::fromJson(path, parsed))
+                return false;
+            view.bones = parsed.bones;
+            view.frameCount = parsed.frameCount;
+            view.ticksPerSecond = parsed.ticksPerSecond;
+            view.matrices = parsed.matrices.data();
+            return true;
+        }
+    };
+
+    bool isDumpFile(const std::filesystem::path& p)
+    {
+        const std::string ext = p.extension().string();
+        return ext == ".posedump" || ext == ".json";
+    }
+
+    /* "pose_dump_animations_Idle.fbx.posedump" and "Idle.json" both
+       name the clip "Idle" */
+    std::string clipNameOf(const std::filesystem::path& p)
+    {
+        std::string name = p.stem().string();
+        for (const char* prefix : { "pose_dump_", "engine_", "animations_" })
+        {
+            const std::string pre(prefix);
+            if (name.compare(0, pre.size(), pre) == 0)
+                name.erase(0, pre.size());
+        }
+        const std::string fbx = ".fbx";
+        if (name.size() > fbx.size() && name.compare(name.size() - fbx.size(), fbx.size(), fbx) == 0)
+            name.erase(name.size() - fbx.size());
+        return name;
+    }
+
+    // Binary first when a clip has both
+    std::map<std::string, std::filesystem::path> dumpsIn(const std::filesystem::path& dir)
+    {
+        std::map<std::string, std::filesystem::path> dumps;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            if (!entry.is_regular_file() || !isDumpFile(entry.path()))
+                continue;
+            auto [it, inserted] = dumps.emplace(clipNameOf(entry.path()), entry.path());
+            if (!inserted && entry.path().extension() == ".posedump")
+                it->second = entry.path();
+        }
+        return dumps;
+    }
+
+    std::string fixed(float v, int decimals)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.*f", decimals, v);
+        return buffer;
+    }
+
+    void logResult(const PoseDiffResult& r, const PoseDiffOptions& options)
+    {
+        if (!r.ok)
+        {
+            Logger::log("[DIFF] " + r.clip + ": could not read both dumps", Logger::ERROR);
+            return;
+        }
+
+        Logger::log("[DIFF] " + r.clip + ": " +
+            std::to_string(std::min(r.referenceFrames, r.engineFrames)) + " frames x " +
+            std::to_string(r.bones.size()) + " bones, max " + fixed(r.maxTranslation, 6) +
+            " / " + fixed(r.maxAngleDeg, 3) + " deg, " + std::to_string(r.samplesOver) +
+            " sample(s) over the limits", r.passes() ? Logger::INFO : Logger::ERROR);
+
+        if (r.referenceFrames != r.engineFrames)
+            Logger::log("[DIFF]   frame count differs: reference " + std::to_string(r.referenceFrames) +
+                ", engine " + std::to_string(r.engineFrames), Logger::ERROR);
+        for (const std::string& bone : r.missingBones)
+            Logger::log("[DIFF]   missing from the engine dump: " + bone, Logger::ERROR);
+
+        const size_t shown = std::min(options.top, r.bones.size());
+        for (size_t i = 0; i < shown; ++i)
+        {
+            const PoseDiffBone& b = r.bones[i];
+            Logger::log("[DIFF]   " + b.bone +
+                "  t " + fixed(b.translation, 6) + " @" + std::to_string(b.translationFrame) +
+                "  rot " + fixed(b.angleDeg, 3) + " deg @" + std::to_string(b.angleFrame) +
+                (b.framesOver ? "  (" + std::to_string(b.framesOver) + " frames over)" : ""),
+                b.framesOver ? Logger::WARNING : Logger::INFO);
+        }
+    }
+
+} // namespace
+
+
+PoseDiffResult PoseDiff::compare(const std::string& referencePath,
+    const std::string& enginePath,
+    const PoseDiffOptions& options)
+{
+    PoseDiffResult result;
+    result.clip = clipNameOf(referencePath);
+
+    LoadedDump reference, engine;
+    if (!reference.load(referencePath) || !engine.load(enginePath))
+        return result;
+
+    const PoseDumpView& ref = reference.view;
+    const PoseDumpView& eng = engine.view;
+    result.ok = true;
+    result.referenceFrames = ref.frameCount;
+    result.engineFrames = eng.frameCount;
+
+    // Reference bones the engine also dumped, as (reference, engine) indices
+    std::unordered_map<std::string, size_t> engineIndex;
+    for (size_t i = 0; i < eng.bones.size(); ++i)
+        engineIndex.emplace(eng.bones[i], i);
+
+    std::vector<std::pair<size_t, size_t>> pairs;
+    for (size_t i = 0; i < ref.bones.size(); ++i)
+    {
+        auto it = engineIndex.find(ref.bones[i]);
+        if (it == engineIndex.end())
+            result.missingBones.push_back(ref.bones[i]);
+        else
+            pairs.emplace_back(i, it->second);
+    }
+
+    const size_t frames = std::min(ref.frameCount, eng.frameCount);
+    const size_t boneCount = pairs.size();
+    std::vector<float> translation(frames * boneCount);
+    std::vector<float> angle(frames * boneCount);
+
+    ThreadPool::shared().parallelFor(frames, [&](size_t f) {
+        for (size_t j = 0; j < boneCount; ++j)
+            matrixError(ref.matrix(f, pairs[j].first), eng.matrix(f, pairs[j].second),
+                translation[f * boneCount + j], angle[f * boneCount + j]);
+        });
+
+    const float maxAngleRad = options.maxAngleDeg / kRadToDeg;
+    result.bones.resize(boneCount);
+    for (size_t j = 0; j < boneCount; ++j)
+    {
+        PoseDiffBone& bone = result.bones[j];
+        bone.bone = ref.bones[pairs[j].first];
+        float worstAngle = 0.0f;
+        for (size_t f = 0; f < frames; ++f)
+        {
+            const float t = translation[f * boneCount + j];
+            const float a = angle[f * boneCount + j];
+            if (t > bone.translation) { bone.translation = t; bone.translationFrame = uint32_t(f); }
+            if (a > worstAngle) { worstAngle = a; bone.angleFrame = uint32_t(f); }
+            if (t > options.maxTranslation || a > maxAngleRad)
+                ++bone.framesOver;
+        }
+        bone.angleDeg = worstAngle * kRadToDeg;
+
+        result.maxTranslation = std::max(result.maxTranslation, bone.translation);
+        result.maxAngleDeg = std::max(result.maxAngleDeg, bone.angleDeg);
+        result.samplesOver += bone.framesOver;
+    }
+
+    // Worst first, each error measured against its own limit
+    auto badness = [&](const PoseDiffBone& b) {
+        return std::max(b.translation / std::max(options.maxTranslation, 1e-12f),
+            b.angleDeg / std::max(options.maxAngleDeg, 1e-12f));
+        };
+    std::sort(result.bones.begin(), result.bones.end(), [&](const PoseDiffBone& x, const PoseDiffBone& y) {
+        return badness(x) > badness(y);
+        });
+    return result;
+}
+
+int PoseDiff::run(const std::string& reference, const std::string& engine, const PoseDiffOptions& options)
+{
+    std::vector<std::pair<std::string, std::string>> jobs;     // (reference, engine)
+    size_t missing = 0;     // reference clips the engine never dumped
+
+    std::error_code ec;
+    if (std::filesystem::is_directory(reference, ec) && std::filesystem::is_directory(engine, ec))
+    {
+        const auto referenceDumps = dumpsIn(reference);
+        const auto engineDumps = dumpsIn(engine);
+        for (const auto& [clip, path] : referenceDumps)
+        {
+            auto it = engineDumps.find(clip);
+            if (it == engineDumps.end())
+            {
+                Logger::log("[DIFF] " + clip + ": no engine dump", Logger::ERROR);
+                ++missing;
+            }
+            else
+                jobs.emplace_back(path.string(), it->second.string());
+        }
+    }
+    else
+    {
+        jobs.emplace_back(reference, engine);
+    }
+
+    if (jobs.empty() && missing == 0)
+    {
+        Logger::log("[DIFF] Nothing to compare", Logger::ERROR);
+        return 1;
+    }
+
+    // Clips in parallel too; each one's frames nest inside
+    std::vector<PoseDiffResult> results(jobs.size());
+    ThreadPool::shared().parallelFor(jobs.size(), [&](size_t i) {
+        results[i] = compare(jobs[i].first, jobs[i].second, options);
+        });
+
+    size_t failed = missing;
+    for (const PoseDiffResult& r : results)
+    {
+        logResult(r, options);
+        if (!r.passes())
+            ++failed;
+    }
+
+    const size_t total = results.size() + missing;
+    Logger::log("[DIFF] " + std::to_string(total - failed) + " of " +
+        std::to_string(total) + " clip(s) within " + fixed(options.maxTranslation, 6) +
+        " / " + fixed(options.maxAngleDeg, 3) + " deg", failed ? Logger::ERROR : Logger::INFO);
+    return failed ? 1 : 0;
+}
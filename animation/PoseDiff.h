@@ -0,0 +1,68 @@
+// PoseDiff.h
+#ifndef POSE_DIFF_H
+#define POSE_DIFF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Limits a clip must stay within, and how much of it to report */
+struct PoseDiffOptions
+{
+    float  maxTranslation = 0.001f;     /* model units */
+    float  maxAngleDeg = 0.5f;
+    size_t top = 10;                    /* worst bones listed per clip */
+};
+
+/* Worst error of one bone over the compared frames */
+struct PoseDiffBone
+{
+    std::string bone;
+    float    translation = 0.0f;
+    uint32_t translationFrame = 0;
+    float    angleDeg = 0.0f;
+    uint32_t angleFrame = 0;
+    size_t   framesOver = 0;            /* frames past either limit */
+};
+
+struct PoseDiffResult
+{
+    std::string clip;
+    bool        ok = false;             /* false: a dump could not be read */
+    uint32_t    referenceFrames = 0;
+    uint32_t    engineFrames = 0;
+    std::vector<std::string> missingBones;  /* in the reference, not in the engine dump */
+    std::vector<PoseDiffBone> bones;        /* worst first */
+    float  maxTranslation = 0.0f;
+    float  maxAngleDeg = 0.0f;
+    size_t samplesOver = 0;
+
+    /* a frame count mismatch or a missing bone fails the clip too */
+    bool passes() const
+    {
+        return ok && samplesOver == 0 && missingBones.empty() && referenceFrames == engineFrames;
+    }
+};
+
+/* Compares engine pose dumps with reference ones, frame by frame and
+   bone by bone: translation distance and rotation angle (scale divided
+   out) between the local matrices. Binary dumps are memory-mapped and
+   read in place; JSON ones (a DCC export in the pose_dump layout) are
+   parsed first. Frames run in parallel on the shared thread pool, each
+   matrix pair through an SSE2 kernel where available.                */
+class PoseDiff
+{
+public:
+    static PoseDiffResult compare(const std::string& referencePath,
+        const std::string& enginePath,
+        const PoseDiffOptions& options = PoseDiffOptions());
+
+    /* `OpenEngine --pose-diff <reference> <engine>`: two dumps, or two
+       directories whose dumps are paired by clip name. Logs the report;
+       returns 0 when every clip passes(), 1 otherwise.              */
+    static int run(const std::string& reference, const std::string& engine,
+        const PoseDiffOptions& options = PoseDiffOptions());
+};
+
+#endif // POSE_DIFF_H
@@ -0,0 +1,407 @@
+// PoseDump.cpp
+#include "PoseDump.h"
+#include "Animation.h"
+#include "../common_utils/Logger.h"
+#include "../nlohmann/json.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+    constexpr char     kMagic[4] = { 'O', 'E', 'P', 'D' };
+    constexpr uint32_t kFormatVersion = 1;
+    constexpr size_t   kFrameAlignment = 16;
+
+    struct FileHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint32_t boneCount;
+        uint32_t frameCount;
+        uint32_t nameBytes;             /* including the padding */
+        float    ticksPerSecond;
+        uint32_t reserved[2];
+    };
+    static_assert(sizeof(FileHeader) % kFrameAlignment == 0, "frames must stay aligned");
+
+    // One writer thread, started by the first request. Dumps run one
+    // after another in request order.
+    struct Writer
+    {
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        std::deque<std::shared_ptr<const Animation>> pending;
+        std::map<const Animation*, std::weak_ptr<const Animation>> requested;   /* requestOnce */
+        bool busy = false;
+        bool stopping = false;
+        std::thread thread;
+
+        ~Writer()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            if (thread.joinable())
+                thread.join();
+        }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;)
+            {
+                wake.wait(lock, [this] { return stopping || !pending.empty(); });
+                if (pending.empty())
+                    return;             // stopping, queue drained
+
+                std::shared_ptr<const Animation> clip = std::move(pending.front());
+                pending.pop_front();
+                busy = true;
+                lock.unlock();
+
+                PoseDump::write(*clip, PoseDump::pathFor(clip->getName()));
+                clip.reset();
+
+                lock.lock();
+                busy = false;
+                if (pending.empty())
+                    idle.notify_all();
+            }
+        }
+    };
+
+    Writer& writer()
+    {
+        static Writer instance;
+        return instance;
+    }
+
+} // namespace
+
+
+std::string PoseDump::pathFor(const std::string& clipName)
+{
+    std::string sanitized = clipName;
+    std::replace(sanitized.begin(), sanitized.end(), '/', '_');
+    std::replace(sanitized.begin(), sanitized.end(), '\\', '_');
+    return "logs/pose_dump_" + sanitized + ".posedump";
+}
+
+void PoseDump::request(std::shared_ptr<const Animation> clip)
+{
+    if (!clip)
+        return;
+
+    Writer& w = writer();
+    {
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.pending.push_back(std::move(clip));
+        if (!w.thread.joinable())
+            w.thread = std::thread([&w] { w.run(); });
+    }
+    w.wake.notify_one();
+}
+
+void PoseDump::requestOnce(const std::shared_ptr<const Animation>& clip)
+{
+    if (!clip)
+        return;
+
+    Writer& w = writer();
+    {
+        // An expired entry is an earlier clip that lived at this address
+        std::lock_guard<std::mutex> lock(w.mutex);
+        std::weak_ptr<const Animation>& seen = w.requested[clip.get()];
+        if (!seen.owner_before(clip) && !clip.owner_before(seen))
+            return;
+        seen = clip;
+    }
+    request(clip);
+}
+
+void PoseDump::wait()
+{
+    Writer& w = writer();
+    std::unique_lock<std::mutex> lock(w.mutex);
+    w.idle.wait(lock, [&w] { return w.pending.empty() && !w.busy; });
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Write: header and names, then one frame at a time             */
+/* -------------------------------------------------------------- */
+bool PoseDump::write(const Animation& clip, const std::string& path)
+{
+    const size_t frameCount = clip.getKeyframeCount();
+    if (!clip.isLoaded() || frameCount == 0)
+    {
+        Logger::log("Pose dump: animation not loaded", Logger::ERROR);
+        return false;
+    }
+
+    // Keys are decoded from the runtime tracks one frame at a time
+    std::vector<std::string> bones;
+    std::string names;
+    for (const auto& [boneName, _] : clip.getKeyframe(0).boneTransforms)
+    {
+        bones.push_back(boneName);
+        names.append(boneName.c_str(), boneName.size() + 1);
+    }
+    names.resize((names.size() + kFrameAlignment - 1) / kFrameAlignment * kFrameAlignment, '\0');
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.boneCount = static_cast<uint32_t>(bones.size());
+    header.frameCount = kIncomplete;
+    header.nameBytes = static_cast<uint32_t>(names.size());
+    header.ticksPerSecond = clip.getTicksPerSecond();
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        Logger::log("ERROR: Could not open output file for pose dump", Logger::ERROR);
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    // Bones a key lacks are written as identity
+    std::vector<float> frame(bones.size() * 16);
+    for (size_t k = 0; k < frameCount; ++k)
+    {
+        const Keyframe kf = clip.getKeyframe(k);
+        for (size_t b = 0; b < bones.size(); ++b)
+        {
+            auto it = kf.boneTransforms.find(bones[b]);
+            const glm::mat4 mat = (it != kf.boneTransforms.end()) ? it->second.toMatrix() : glm::mat4(1.0f);
+            std::memcpy(&frame[b * 16], &mat[0][0], 16 * sizeof(float));
+        }
+        out.write(reinterpret_cast<const char*>(frame.data()),
+            static_cast<std::streamsize>(frame.size() * sizeof(float)));
+    }
+
+    header.frameCount = static_cast<uint32_t>(frameCount);
+    out.seekp(offsetof(FileHeader, frameCount));
+    out.write(reinterpret_cast<const char*>(&header.frameCount), sizeof(header.frameCount));
+    if (!out)
+    {
+        Logger::log("ERROR: Pose dump write failed for " + path, Logger::ERROR);
+        return false;
+    }
+
+    Logger::log("Pose dump complete for animation: " + clip.getName(), Logger::INFO);
+    return true;
+}
+
+
+/* -------------------------------------------------------------- */
+/*  Read / JSON                                                   */
+/* -------------------------------------------------------------- */
+bool PoseDump::parse(const char* bytes, size_t size, PoseDumpView& out, const std::string& source)
+{
+    if (size < sizeof(FileHeader))
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kFormatVersion)
+    {
+        Logger::log("Unrecognised pose dump " + source, Logger::WARNING);
+        return false;
+    }
+    if (sizeof(FileHeader) + size_t(header.nameBytes) > size)
+        return false;
+
+    const size_t frameBytes = size_t(header.boneCount) * 16 * sizeof(float);
+    const size_t dataBytes = size - sizeof(FileHeader) - header.nameBytes;
+    size_t frameCount = header.frameCount;
+    if (frameCount == kIncomplete)
+    {
+        frameCount = frameBytes ? dataBytes / frameBytes : 0;
+        Logger::log("Pose dump " + source + " is incomplete; reading " +
+            std::to_string(frameCount) + " frame(s)", Logger::WARNING);
+    }
+    else if (frameCount * frameBytes != dataBytes)
+    {
+        Logger::log("Truncated pose dump " + source, Logger::WARNING);
+        return false;
+    }
+
+    const char* cursor = bytes + sizeof(FileHeader);
+    const char* namesEnd = cursor + header.nameBytes;
+    std::vector<std::string> bones;
+    while (bones.size() < header.boneCount && cursor < namesEnd)
+    {
+        const char* end = static_cast<const char*>(std::memchr(cursor, '\0', namesEnd - cursor));
+        if (!end)
+            return false;
+        bones.emplace_back(cursor, end);
+        cursor = end + 1;
+    }
+    if (bones.size() != header.boneCount)
+        return false;
+
+    out.bones = std::move(bones);
+    out.frameCount = static_cast<uint32_t>(frameCount);
+    out.ticksPerSecond = header.ticksPerSecond;
+    out.matrices = reinterpret_cast<const float*>(namesEnd);
+    return true;
+}
+
+bool PoseDump::read(const std::string& path, PoseDumpData& out)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+
+    const std::streamsize size = in.tellg();
+    if (size <= 0)
+        return false;
+
+    std::vector<char> bytes(static_cast<size_t>(size));
+    in.seekg(0);
+    if (!in.read(bytes.data(), size))
+        return false;
+
+    PoseDumpView view;
+    if (!parse(bytes.data(), bytes.size(), view, path))
+        return false;
+
+    out.bones = std::move(view.bones);
+    out.frameCount = view.frameCount;
+    out.ticksPerSecond = view.ticksPerSecond;
+    out.matrices.resize(size_t(view.frameCount) * out.bones.size() * 16);
+    std::memcpy(out.matrices.data(), view.matrices, out.matrices.size() * sizeof(float));
+    return true;
+}
+
+bool PoseDump::fromJson(const std::string& jsonPath, PoseDumpData& out)
+{
+    std::ifstream in(jsonPath);
+    if (!in)
+        return false;
+
+    const nlohmann::json root = nlohmann::json::parse(in, nullptr, false);
+    if (root.is_discarded() || !root.is_object() || root.empty())
+    {
+        Logger::log("Not a pose dump: " + jsonPath, Logger::WARNING);
+        return false;
+    }
+
+    // Frames are keyed "0".."N-1"; the bones are those of frame 0
+    const nlohmann::json* first = root.contains("0") ? &root["0"] : nullptr;
+    if (!first || !first->is_object())
+    {
+        Logger::log("Pose dump " + jsonPath + " has no frame 0", Logger::WARNING);
+        return false;
+    }
+
+    out.bones.clear();
+    for (const auto& [boneName, _] : first->items())
+        out.bones.push_back(boneName);
+
+    out.frameCount = static_cast<uint32_t>(root.size());
+    out.ticksPerSecond = 0.0f;
+    out.matrices.assign(size_t(out.frameCount) * out.bones.size() * 16, 0.0f);
+
+    for (uint32_t f = 0; f < out.frameCount; ++f)
+    {
+        auto frameIt = root.find(std::to_string(f));
+        if (frameIt == root.end() || !frameIt->is_object())
+        {
+            Logger::log("Pose dump " + jsonPath + " is missing frame " + std::to_string(f), Logger::WARNING);
+            return false;
+        }
+
+        for (size_t b = 0; b < out.bones.size(); ++b)
+        {
+            float* m = out.matrices.data() + (size_t(f) * out.bones.size() + b) * 16;
+            auto boneIt = frameIt->find(out.bones[b]);
+            if (boneIt == frameIt->end())
+            {
+                for (int i = 0; i < 4; ++i)
+                    m[i * 5] = 1.0f;        // absent: identity, as the writer does
+                continue;
+            }
+
+            // Four rows of four numbers, or the file is rejected
+            bool wellFormed = boneIt->is_array() && boneIt->size() == 4;
+            for (int row = 0; wellFormed && row < 4; ++row)
+            {
+                const nlohmann::json& r = (*boneIt)[row];
+                wellFormed = r.is_array() && r.size() == 4;
+                for (int col = 0; wellFormed && col < 4; ++col)
+                    wellFormed = r[col].is_number();
+            }
+            if (!wellFormed)
+            {
+                Logger::log("Pose dump " + jsonPath + ": frame " + std::to_string(f) + ", bone " +
+                    out.bones[b] + " is not a 4x4 matrix of numbers", Logger::ERROR);
+                return false;
+            }
+
+            for (int row = 0; row < 4; ++row)
+                for (int col = 0; col < 4; ++col)
+                    m[col * 4 + row] = (*boneIt)[row][col].get<float>();   // row-major to column-major
+        }
+    }
+    return true;
+}
+
+bool PoseDump::toJson(const std::string& dumpPath, const std::string& jsonPath)
+{
+    PoseDumpData dump;
+    if (!read(dumpPath, dump))
+    {
+        Logger::log("Cannot read pose dump " + dumpPath, Logger::ERROR);
+        return false;
+    }
+
+    std::ofstream out(jsonPath, std::ios::trunc);
+    if (!out)
+    {
+        Logger::log("ERROR: Could not open " + jsonPath, Logger::ERROR);
+        return false;
+    }
+    out.precision(std::numeric_limits<float>::max_digits10);
+
+    out << "{";
+    for (size_t f = 0; f < dump.frameCount; ++f)
+    {
+        out << (f ? ",\n" : "\n") << "  \"" << f << "\": {";
+        for (size_t b = 0; b < dump.bones.size(); ++b)
+        {
+            const float* m = dump.matrix(f, b);
+            out << (b ? ",\n" : "\n") << "    \"" << dump.bones[b] << "\": [";
+            for (int row = 0; row < 4; ++row)
+            {
+                out << (row ? ", [" : "[");
+                for (int col = 0; col < 4; ++col)
+                    out << (col ? ", " : "") << m[col * 4 + row];  // column-major to row-major
+                out << "]";
+            }
+            out << "]";
+        }
+        out << "\n  }";
+    }
+    out << "\n}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,87 @@
+// PoseDump.h
+#ifndef POSE_DUMP_H
+#define POSE_DUMP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Animation;
+
+/* A pose dump read back into memory: every baked key of a clip as the
+   local matrix of each bone, 16 floats in glm (column-major) order. */
+struct PoseDumpData
+{
+    std::vector<std::string> bones;
+    uint32_t frameCount = 0;
+    float    ticksPerSecond = 0.0f;
+    std::vector<float> matrices;         /* [frame][bone][16] */
+
+    const float* matrix(size_t frame, size_t bone) const
+    {
+        return matrices.data() + (frame * bones.size() + bone) * 16;
+    }
+};
+
+/* The same, parsed in place from bytes someone else owns (a mapped
+   file); matrices points into them, 16-byte aligned when they are. */
+struct PoseDumpView
+{
+    std::vector<std::string> bones;
+    uint32_t frameCount = 0;
+    float    ticksPerSecond = 0.0f;
+    const float* matrices = nullptr;
+
+    const float* matrix(size_t frame, size_t bone) const
+    {
+        return matrices + (frame * bones.size() + bone) * 16;
+    }
+};
+
+/* Binary replacement for the pose_dump_*.json files. Layout, native
+   endianness:
+     header     "OEPD", version, boneCount, frameCount, nameBytes,
+                ticksPerSecond
+     names      boneCount '\0'-terminated names, zero-padded so the
+                frames start 16-byte aligned
+     frames     frameCount x boneCount x 16 floats
+   Frames are streamed out one at a time and frameCount is filled in
+   last; a dump cut short keeps kIncomplete there and the reader counts
+   the whole frames that made it to disk.                              */
+class PoseDump
+{
+public:
+    static constexpr uint32_t kIncomplete = 0xFFFFFFFFu;
+
+    /* logs/pose_dump_<clip path, flattened>.posedump */
+    static std::string pathFor(const std::string& clipName);
+
+    /* Queues a dump of the clip for the writer thread and returns at
+       once. The queue keeps the clip alive; batch tools that modify
+       clips call wait() first.                                      */
+    static void request(std::shared_ptr<const Animation> clip);
+
+    /* request(), unless this clip was requested before */
+    static void requestOnce(const std::shared_ptr<const Animation>& clip);
+
+    /* Returns once every queued dump has been written */
+    static void wait();
+
+    /* Synchronous dump, the writer thread's job */
+    static bool write(const Animation& clip, const std::string& path);
+
+    /* source names the bytes in log messages */
+    static bool parse(const char* bytes, size_t size, PoseDumpView& out, const std::string& source);
+    static bool read(const std::string& path, PoseDumpData& out);
+
+    /* Loads a JSON dump (toJson's layout, or a DCC export in it) */
+    static bool fromJson(const std::string& jsonPath, PoseDumpData& out);
+
+    /* Streams a dump out in the old JSON layout: { "frame": { "bone":
+       [[row], [row], [row], [row]] } } with row-major rows.           */
+    static bool toJson(const std::string& dumpPath, const std::string& jsonPath);
+};
+
+#endif // POSE_DUMP_H
@@ -0,0 +1,156 @@
+// PoseKernels.cpp
+#include "PoseKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define POSE_KERNELS_X86 1
+#include "PoseKernelsImpl.h"
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#include <atomic>
+
+namespace {
+
+#if POSE_KERNELS_X86
+    /* -------- 4-lane SSE2 float ----------------------------------- */
+    struct F4
+    {
+        static constexpr size_t width = 4;
+        __m128 v;
+
+        F4() = default;
+        F4(__m128 x) : v(x) {}
+
+        static F4 splat(float f) { return _mm_set1_ps(f); }
+        static F4 load(const float* p) { return _mm_load_ps(p); }
+        void store(float* p) const { _mm_store_ps(p, v); }
+    };
+
+    inline F4 operator+(F4 a, F4 b) { return _mm_add_ps(a.v, b.v); }
+    inline F4 operator-(F4 a, F4 b) { return _mm_sub_ps(a.v, b.v); }
+    inline F4 operator*(F4 a, F4 b) { return _mm_mul_ps(a.v, b.v); }
+    inline F4 operator/(F4 a, F4 b) { return _mm_div_ps(a.v, b.v); }
+    inline F4 operator-(F4 a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+    inline F4 operator&(F4 a, F4 b) { return _mm_and_ps(a.v, b.v); }
+    inline F4 sqrt(F4 a) { return _mm_sqrt_ps(a.v); }
+    inline F4 min(F4 a, F4 b) { return _mm_min_ps(a.v, b.v); }
+    inline F4 max(F4 a, F4 b) { return _mm_max_ps(a.v, b.v); }
+    inline F4 abs(F4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+    inline F4 lessThan(F4 a, F4 b) { return _mm_cmplt_ps(a.v, b.v); }
+    inline F4 greaterThan(F4 a, F4 b) { return _mm_cmpgt_ps(a.v, b.v); }
+    inline F4 select(F4 mask, F4 a, F4 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+    }
+
+    /* -------- CPU detection ---------------------------------------- */
+    void cpuid(int leaf, int sub, unsigned regs[4])
+    {
+#if defined(_MSC_VER)
+        int r[4];
+        __cpuidex(r, leaf, sub);
+        for (int i = 0; i < 4; ++i)
+            regs[i] = static_cast<unsigned>(r[i]);
+#else
+        __cpuid_count(leaf, sub, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+
+    unsigned long long readXcr0()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned lo = 0, hi = 0;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+    }
+
+    // AVX2 needs the CPU flag and the OS saving the YMM registers
+    bool cpuHasAvx2()
+    {
+        unsigned regs[4];
+        cpuid(0, 0, regs);
+        if (regs[0] < 7)
+            return false;
+
+        cpuid(1, 0, regs);
+        const bool osxsave = (regs[2] & (1u << 27)) != 0;
+        const bool avx = (regs[2] & (1u << 28)) != 0;
+        if (!osxsave || !avx || (readXcr0() & 0x6) != 0x6)
+            return false;
+
+        cpuid(7, 0, regs);
+        return (regs[1] & (1u << 5)) != 0;
+    }
+#endif
+
+    struct Kernel
+    {
+        const char* name;
+        size_t width;
+        void (*evaluate)(PoseKernels::CubicLanes&);
+    };
+
+    const Kernel kScalar = { "scalar", 1, nullptr };
+
+    const Kernel& detectKernel()
+    {
+#if POSE_KERNELS_X86
+        static const Kernel kSse2 = { "sse2", 4, &PoseKernels::evaluateCubicSse2 };
+        static const Kernel kAvx2 = { "avx2", 8, &PoseKernels::evaluateCubicAvx2 };
+        static const Kernel& best = cpuHasAvx2() ? kAvx2 : kSse2;
+        return best;
+#else
+        return kScalar;
+#endif
+    }
+
+    std::atomic<bool> simdEnabled{ true };
+
+    const Kernel& activeKernel()
+    {
+        return simdEnabled.load(std::memory_order_relaxed) ? detectKernel() : kScalar;
+    }
+
+} // namespace
+
+
+namespace PoseKernels {
+
+#if POSE_KERNELS_X86
+    void evaluateCubicSse2(CubicLanes& lanes)
+    {
+        detail::evaluateAll<F4>(lanes, 4);
+    }
+#endif
+
+    size_t getLaneWidth()
+    {
+        return activeKernel().width;
+    }
+
+    const char* getKernelName()
+    {
+        return activeKernel().name;
+    }
+
+    void setSimdEnabled(bool enabled)
+    {
+        simdEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void evaluateCubic(CubicLanes& lanes)
+    {
+        const Kernel& kernel = activeKernel();
+        if (kernel.evaluate)
+            kernel.evaluate(lanes);
+    }
+
+} // namespace PoseKernels
@@ -0,0 +1,66 @@
+// PoseKernels.h
+#ifndef POSE_KERNELS_H
+#define POSE_KERNELS_H
+
+#include <cstddef>
+
+/* Batched segment evaluation for pose sampling: the same maths as
+   interpolateTransformsBaked in Animation.cpp (hemisphere alignment,
+   squad/slerp on the baked control points, Hermite translation on the
+   baked slopes, linear scale) run on 4 (SSE2) or 8 (AVX2) bones at
+   once. The instruction set is picked at runtime; without either the
+   caller keeps its scalar per-bone path.
+
+   Tolerance against the scalar glm path: rotation components within
+   1e-6, translations and scales within 1e-6 * max(1, |x|). The kernels
+   use polynomial atan2/sin in place of acos/sin.
+
+   Lanes that are not cubic (no real neighbour on either side, or a
+   two-key segment) evaluate as slerp + linear, as the scalar fallback
+   does. */
+namespace PoseKernels {
+
+    constexpr size_t kMaxLanes = 8;
+
+    /* Structure of arrays, component-major: rotations are w,x,y,z and
+       vectors x,y,z, one lane per bone. Unused lanes must still hold
+       valid keys (copy a used lane).                                   */
+    struct CubicLanes
+    {
+        alignas(32) float rotA[4][kMaxLanes];
+        alignas(32) float rotB[4][kMaxLanes];
+        alignas(32) float controlA[4][kMaxLanes];   /* squad control points, keys' own hemispheres */
+        alignas(32) float controlB[4][kMaxLanes];
+
+        alignas(32) float transA[3][kMaxLanes];
+        alignas(32) float transB[3][kMaxLanes];
+        alignas(32) float slopeA[3][kMaxLanes];     /* Hermite slopes at a and b */
+        alignas(32) float slopeB[3][kMaxLanes];
+
+        alignas(32) float scaleA[3][kMaxLanes];
+        alignas(32) float scaleB[3][kMaxLanes];
+
+        alignas(32) float factor[kMaxLanes];
+        alignas(32) float havePrev[kMaxLanes];    /* 1.0f: a has a real neighbour before it */
+        alignas(32) float haveNext[kMaxLanes];
+
+        /* outputs */
+        alignas(32) float rotation[4][kMaxLanes];
+        alignas(32) float translation[3][kMaxLanes];
+        alignas(32) float scale[3][kMaxLanes];
+    };
+
+    /* Lanes per evaluateCubic call: 8, 4, or 1 when no SIMD kernel is
+       usable (the caller should evaluate bones one by one instead).   */
+    size_t getLaneWidth();
+    const char* getKernelName();
+
+    /* false forces the scalar path, e.g. to A/B the kernels */
+    void setSimdEnabled(bool enabled);
+
+    /* Evaluates the first getLaneWidth() lanes */
+    void evaluateCubic(CubicLanes& lanes);
+
+} // namespace PoseKernels
+
+#endif // POSE_KERNELS_H
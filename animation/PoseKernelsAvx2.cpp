@@ -0,0 +1,47 @@
+// PoseKernelsAvx2.cpp
+// Built with AVX2 enabled (/arch:AVX2, -mavx2) and only entered after
+// PoseKernels.cpp has checked the CPU, so keep the includes to intrinsics
+// and the kernel header.
+#include "PoseKernelsImpl.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+namespace {
+
+    /* -------- 8-lane AVX float ------------------------------------- */
+    struct F8
+    {
+        static constexpr size_t width = 8;
+        __m256 v;
+
+        F8() = default;
+        F8(__m256 x) : v(x) {}
+
+        static F8 splat(float f) { return _mm256_set1_ps(f); }
+        static F8 load(const float* p) { return _mm256_load_ps(p); }
+        void store(float* p) const { _mm256_store_ps(p, v); }
+    };
+
+    inline F8 operator+(F8 a, F8 b) { return _mm256_add_ps(a.v, b.v); }
+    inline F8 operator-(F8 a, F8 b) { return _mm256_sub_ps(a.v, b.v); }
+    inline F8 operator*(F8 a, F8 b) { return _mm256_mul_ps(a.v, b.v); }
+    inline F8 operator/(F8 a, F8 b) { return _mm256_div_ps(a.v, b.v); }
+    inline F8 operator-(F8 a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+    inline F8 operator&(F8 a, F8 b) { return _mm256_and_ps(a.v, b.v); }
+    inline F8 sqrt(F8 a) { return _mm256_sqrt_ps(a.v); }
+    inline F8 min(F8 a, F8 b) { return _mm256_min_ps(a.v, b.v); }
+    inline F8 max(F8 a, F8 b) { return _mm256_max_ps(a.v, b.v); }
+    inline F8 abs(F8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+    inline F8 lessThan(F8 a, F8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+    inline F8 greaterThan(F8 a, F8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+    inline F8 select(F8 mask, F8 a, F8 b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+
+} // namespace
+
+void PoseKernels::evaluateCubicAvx2(CubicLanes& lanes)
+{
+    detail::evaluateAll<F8>(lanes, 8);
+}
+
+#endif
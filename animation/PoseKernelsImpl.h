@@ -0,0 +1,218 @@
+// PoseKernelsImpl.h
+#ifndef POSE_KERNELS_IMPL_H
+#define POSE_KERNELS_IMPL_H
+
+/* Kernel body shared by the SSE2 and AVX2 translation units. F is a lane
+   type (F4, F8) with the arithmetic operators plus splat/load/store,
+   sqrt, min, max, abs, lessThan, greaterThan and select. Only intrinsics
+   and this header may be pulled into the AVX2 unit: anything inline it
+   emits is built with AVX2 enabled and must not be shared with callers
+   that run on older CPUs.                                                */
+
+#include "PoseKernels.h"
+
+namespace PoseKernels {
+
+    void evaluateCubicSse2(CubicLanes& lanes);
+    void evaluateCubicAvx2(CubicLanes& lanes);
+
+    namespace detail {
+
+        template <typename F> struct QuatL { F w, x, y, z; };
+        template <typename F> struct Vec3L { F x, y, z; };
+
+        template <typename F>
+        inline QuatL<F> loadQuat(const float (&c)[4][kMaxLanes], size_t lane)
+        {
+            return { F::load(&c[0][lane]), F::load(&c[1][lane]), F::load(&c[2][lane]), F::load(&c[3][lane]) };
+        }
+
+        template <typename F>
+        inline Vec3L<F> loadVec3(const float (&c)[3][kMaxLanes], size_t lane)
+        {
+            return { F::load(&c[0][lane]), F::load(&c[1][lane]), F::load(&c[2][lane]) };
+        }
+
+        template <typename F>
+        inline void storeQuat(const QuatL<F>& q, float (&c)[4][kMaxLanes], size_t lane)
+        {
+            q.w.store(&c[0][lane]); q.x.store(&c[1][lane]); q.y.store(&c[2][lane]); q.z.store(&c[3][lane]);
+        }
+
+        template <typename F>
+        inline void storeVec3(const Vec3L<F>& v, float (&c)[3][kMaxLanes], size_t lane)
+        {
+            v.x.store(&c[0][lane]); v.y.store(&c[1][lane]); v.z.store(&c[2][lane]);
+        }
+
+        template <typename F>
+        inline F dot(const QuatL<F>& a, const QuatL<F>& b)
+        {
+            return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
+        template <typename F>
+        inline QuatL<F> scaled(const QuatL<F>& q, const F& s)
+        {
+            return { q.w * s, q.x * s, q.y * s, q.z * s };
+        }
+
+        template <typename F>
+        inline QuatL<F> selectQuat(const F& mask, const QuatL<F>& a, const QuatL<F>& b)
+        {
+            return { select(mask, a.w, b.w), select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z) };
+        }
+
+        template <typename F>
+        inline QuatL<F> normalize(const QuatL<F>& q)
+        {
+            return scaled(q, F::splat(1.0f) / sqrt(dot(q, q)));
+        }
+
+        /* sin(x) for |x| <= pi/2, Taylor to x^11 (error < 6e-8) */
+        template <typename F>
+        inline F sinHalfPi(const F& x)
+        {
+            const F x2 = x * x;
+            F p = F::splat(-2.5052108e-8f);
+            p = p * x2 + F::splat(2.7557319e-6f);
+            p = p * x2 + F::splat(-1.9841270e-4f);
+            p = p * x2 + F::splat(8.3333333e-3f);
+            p = p * x2 + F::splat(-1.6666667e-1f);
+            return x + x * x2 * p;
+        }
+
+        /* sin(x) for x in [0, pi] */
+        template <typename F>
+        inline F sinPi(const F& x)
+        {
+            return sinHalfPi(min(x, F::splat(3.14159265f) - x));
+        }
+
+        /* atan2(y, x) for y >= 0: octant reduction to [0, 1], then the
+           Cephes atanf polynomial around tan(pi/8) (error ~1e-7)        */
+        template <typename F>
+        inline F atan2Pos(const F& y, const F& x)
+        {
+            const F ax = abs(x);
+            const F swap = greaterThan(y, ax);
+            const F num = select(swap, ax, y);
+            const F den = select(swap, y, ax);
+            F r = num / max(den, F::splat(1e-30f));
+
+            const F upper = greaterThan(r, F::splat(0.41421356f));
+            r = select(upper, (r - F::splat(1.0f)) / (r + F::splat(1.0f)), r);
+
+            const F z = r * r;
+            F p = F::splat(8.05374449538e-2f);
+            p = p * z - F::splat(1.38776856032e-1f);
+            p = p * z + F::splat(1.99777106478e-1f);
+            p = p * z - F::splat(3.33329491539e-1f);
+            F a = r + r * z * p;
+
+            a = select(upper, a + F::splat(0.78539816f), a);
+            a = select(swap, F::splat(1.57079633f) - a, a);
+            return select(lessThan(x, F::splat(0.0f)), F::splat(3.14159265f) - a, a);
+        }
+
+        /* glm::slerp: shortest path, linear mix once the keys are within
+           float epsilon of each other                                    */
+        template <typename F>
+        inline QuatL<F> slerp(const QuatL<F>& x, const QuatL<F>& y, const F& t)
+        {
+            F c = dot(x, y);
+            const QuatL<F> z = selectQuat(lessThan(c, F::splat(0.0f)), QuatL<F>{ -y.w, -y.x, -y.y, -y.z }, y);
+            c = abs(c);
+
+            const F one = F::splat(1.0f);
+            const F sinAngle = sqrt(max(one - c * c, F::splat(0.0f)));
+            const F angle = atan2Pos(sinAngle, c);
+            const F inv = one / max(sinAngle, F::splat(1e-30f));
+
+            const F linear = greaterThan(c, F::splat(1.0f - 1.1920929e-7f));
+            const F wx = select(linear, one - t, sinPi((one - t) * angle) * inv);
+            const F wz = select(linear, t, sinPi(t * angle) * inv);
+
+            return { x.w * wx + z.w * wz, x.x * wx + z.x * wz, x.y * wx + z.y * wz, x.z * wx + z.z * wz };
+        }
+
+        template <typename F>
+        inline QuatL<F> squad(const QuatL<F>& q0, const QuatL<F>& s0, const QuatL<F>& s1, const QuatL<F>& q1, const F& t)
+        {
+            const QuatL<F> q01 = slerp(q0, q1, t);
+            const QuatL<F> s01 = slerp(s0, s1, t);
+            return normalize(slerp(q01, s01, F::splat(2.0f) * t * (F::splat(1.0f) - t)));
+        }
+
+        template <typename F>
+        inline F hermite(const F& p0, const F& m0, const F& p1, const F& m1, const F& t)
+        {
+            const F t2 = t * t;
+            const F t3 = t2 * t;
+            const F h00 = F::splat(2.0f) * t3 - F::splat(3.0f) * t2 + F::splat(1.0f);
+            const F h10 = t3 - F::splat(2.0f) * t2 + t;
+            const F h01 = F::splat(-2.0f) * t3 + F::splat(3.0f) * t2;
+            const F h11 = t3 - t2;
+            return h00 * p0 + h10 * m0 + h01 * p1 + h11 * m1;
+        }
+
+        /* One F::width block of interpolateTransformsBaked */
+        template <typename F>
+        inline void evaluateBlock(CubicLanes& L, size_t lane)
+        {
+            const F t = F::load(&L.factor[lane]);
+            const F half = F::splat(0.5f);
+            const F hasPrev = greaterThan(F::load(&L.havePrev[lane]), half);
+            const F hasNext = greaterThan(F::load(&L.haveNext[lane]), half);
+
+            /* ---- rotation: b and its control point follow a's hemisphere ---- */
+            const QuatL<F> rA = loadQuat<F>(L.rotA, lane);
+            QuatL<F> rB = loadQuat<F>(L.rotB, lane);
+            QuatL<F> s1 = loadQuat<F>(L.controlB, lane);
+            const F flip = lessThan(dot(rB, rA), F::splat(0.0f));
+            rB = selectQuat(flip, QuatL<F>{ -rB.w, -rB.x, -rB.y, -rB.z }, rB);
+            s1 = selectQuat(flip, QuatL<F>{ -s1.w, -s1.x, -s1.y, -s1.z }, s1);
+
+            const QuatL<F> nA = normalize(rA);
+            const QuatL<F> nB = normalize(rB);
+            const QuatL<F> curved = squad(nA, loadQuat<F>(L.controlA, lane), s1, nB, t);
+            const QuatL<F> straight = slerp(nA, nB, t);
+
+            const F cubic = hasPrev & hasNext;
+            storeQuat(normalize(selectQuat(cubic, curved, straight)), L.rotation, lane);
+
+            /* ---- translation: Hermite, chord slope at the ends ---- */
+            const Vec3L<F> tA = loadVec3<F>(L.transA, lane);
+            const Vec3L<F> tB = loadVec3<F>(L.transB, lane);
+            const Vec3L<F> mA = loadVec3<F>(L.slopeA, lane);
+            const Vec3L<F> mB = loadVec3<F>(L.slopeB, lane);
+
+            auto channel = [&](const F& a, const F& b, const F& slopeA, const F& slopeB) {
+                const F chord = b - a;
+                return hermite(a, select(hasPrev, slopeA, chord), b, select(hasNext, slopeB, chord), t);
+                };
+            storeVec3(Vec3L<F>{
+                channel(tA.x, tB.x, mA.x, mB.x),
+                channel(tA.y, tB.y, mA.y, mB.y),
+                channel(tA.z, tB.z, mA.z, mB.z) }, L.translation, lane);
+
+            /* ---- scale: linear ---- */
+            const Vec3L<F> sA = loadVec3<F>(L.scaleA, lane);
+            const Vec3L<F> sB = loadVec3<F>(L.scaleB, lane);
+            storeVec3(Vec3L<F>{
+                sA.x + (sB.x - sA.x) * t,
+                sA.y + (sB.y - sA.y) * t,
+                sA.z + (sB.z - sA.z) * t }, L.scale, lane);
+        }
+
+        template <typename F>
+        inline void evaluateAll(CubicLanes& lanes, size_t width)
+        {
+            for (size_t lane = 0; lane < width; lane += F::width)
+                evaluateBlock<F>(lanes, lane);
+        }
+
+    } // namespace detail
+} // namespace PoseKernels
+
+#endif // POSE_KERNELS_IMPL_H
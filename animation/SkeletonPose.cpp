@@ -16,37 +16,31 @@ SkeletonPose::SkeletonPose(
         invGlobalNoScale[p.first] = glm::inverse(removeScale(p.second));
 }
 
+// Bones missing from the sample hold their local bind pose; roots sit
+// under the FBX root transform. Only sampled bones are returned.
 SkeletonPose SkeletonPose::fromAnimationSample(
     const std::map<std::string, glm::mat4>& localBoneTransforms,
     const Model* model)
 {
     SkeletonPose pose;
 
+    std::vector<glm::mat4> localPose = model->getLocalBindPoses();
     for (const auto& [boneName, localTransform] : localBoneTransforms)
     {
-        glm::mat4 parentGlobal = glm::mat4(1.0f);
-        std::string parent = model->getBoneParent(boneName);
-
-        if (!parent.empty())
-        {
-            auto it = pose.boneTransforms.find(parent);
-            if (it != pose.boneTransforms.end())
-            {
-                parentGlobal = it->second;
-            }
-            else
-            {
-                parentGlobal = model->getBindPoseGlobalTransform(parent);
-            }
-        }
-        else
-        {
-            // Apply FBX rootTransform to root bones
-            parentGlobal = model->getRootTransform();
-        }
+        int index = model->getBoneIndex(boneName);
+        if (index >= 0)
+            localPose[index] = localTransform;
+    }
 
+    std::vector<glm::mat4> globalPose;
+    model->computeGlobalPose(localPose, globalPose, model->getRootTransform());
 
-        glm::mat4 globalTransform = parentGlobal * localTransform;
+    for (const auto& [boneName, localTransform] : localBoneTransforms)
+    {
+        int index = model->getBoneIndex(boneName);
+        glm::mat4 globalTransform = (index >= 0)
+            ? globalPose[index]
+            : model->getRootTransform() * localTransform;
         pose.boneTransforms[boneName] = globalTransform;
 
         if (boneName == "DEF-forearm.L" || boneName == "DEF-upper_arm.L")
@@ -0,0 +1,45 @@
+// SkinPaletteTable.cpp
+#include "SkinPaletteTable.h"
+#include "Animation.h"
+#include "../model/Model.h"
+#include "../common_utils/ThreadPool.h"
+
+#include <algorithm>
+
+std::unique_ptr<SkinPaletteTable> SkinPaletteTable::build(const Animation& clip, const Model& model)
+{
+    const size_t frameCount = clip.getKeyframeCount();
+    const size_t boneCount = model.getBones().size();
+    if (!clip.isLoaded() || frameCount == 0 || boneCount == 0)
+        return nullptr;
+
+    std::unique_ptr<SkinPaletteTable> table(new SkinPaletteTable());
+    table->clip = &clip;
+    table->model = &model;
+    table->clipRevision = clip.getRevision();
+    table->frameCount = frameCount;
+    table->boneCount = boneCount;
+    table->palettes.resize(frameCount * boneCount);
+
+    // Same steps as AnimationController::applyToModel at key k's time
+    const size_t poseCount = std::max(boneCount, clip.getTrackCount());
+    const std::vector<glm::mat4>& bindPoses = model.getLocalBindPoses();
+
+    ThreadPool::shared().parallelFor(frameCount, [&](size_t k) {
+        std::vector<glm::mat4> localPose(poseCount, glm::mat4(1.0f));
+        std::vector<glm::mat4> globalPose(boneCount);
+        std::copy(bindPoses.begin(), bindPoses.end(), localPose.begin());
+
+        clip.sampleBoneTracks(clip.getKeyTime(k), localPose.data());
+        model.computeGlobalPose(localPose.data(), globalPose.data());
+        model.computeSkinPalette(globalPose.data(), boneCount, table->palettes.data() + k * boneCount);
+        });
+
+    return table;
+}
+
+bool SkinPaletteTable::matches(const Animation& other, const Model& otherModel) const
+{
+    return clip == &other && model == &otherModel && clipRevision == other.getRevision() &&
+        frameCount == other.getKeyframeCount() && boneCount == otherModel.getBones().size();
+}
@@ -0,0 +1,48 @@
+// SkinPaletteTable.h
+#ifndef SKIN_PALETTE_TABLE_H
+#define SKIN_PALETTE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Animation;
+class Model;
+
+/* Final skin matrices for every baked key of one clip on one model:
+   what applyToModel would compute when playback sits on that key
+   (bind pose under the sampled tracks, global pose, globalInverse *
+   global * offset). Playback of the clip then only points the model
+   at a row - see Model::useSkinPalette. Costs frames x bones x 64
+   bytes, e.g. ~4.7 MB for 1241 frames of a 60-bone rig.              */
+class SkinPaletteTable
+{
+public:
+    /* Every key in parallel on the shared thread pool. nullptr if the
+       clip has no runtime tracks or the model no bones.             */
+    static std::unique_ptr<SkinPaletteTable> build(const Animation& clip, const Model& model);
+
+    /* Still what build() would produce: same clip and model, and the
+       clip has not been re-smoothed since                           */
+    bool matches(const Animation& clip, const Model& model) const;
+
+    size_t getFrameCount() const { return frameCount; }
+    size_t getBoneCount() const { return boneCount; }
+    size_t getByteSize() const { return palettes.size() * sizeof(glm::mat4); }
+
+    const glm::mat4* getFrame(size_t frame) const { return palettes.data() + frame * boneCount; }
+
+private:
+    SkinPaletteTable() = default;
+
+    const Animation* clip = nullptr;
+    const Model* model = nullptr;
+    uint32_t clipRevision = 0;
+    size_t frameCount = 0;
+    size_t boneCount = 0;
+    std::vector<glm::mat4> palettes;     /* [frame][bone] */
+};
+
+#endif // SKIN_PALETTE_TABLE_H
@@ -0,0 +1,139 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+    thread_local uint64_t threadAllocations = 0;
+    std::atomic<uint64_t> totalAllocations{ 0 };
+
+#ifndef OPENENGINE_NO_ALLOCATION_COUNTER
+
+    // malloc, or the aligned allocator for alignment > 0, retried
+    // through the new handler as the standard operator new does
+    void* countedAllocate(std::size_t size, std::size_t alignment)
+    {
+        ++threadAllocations;
+        totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        if (size == 0)
+            size = 1;
+        for (;;)
+        {
+            void* p;
+            if (alignment == 0)
+                p = std::malloc(size);
+            else
+#ifdef _WIN32
+                p = _aligned_malloc(size, alignment);
+#else
+                p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+            if (p)
+                return p;
+
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    void alignedFree(void* p)
+    {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+#endif
+
+} // namespace
+
+#ifndef OPENENGINE_NO_ALLOCATION_COUNTER
+
+// Every form that allocates is replaced - array, nothrow and aligned
+// ones included, so over-aligned types are counted too. Each delete
+// form matches its new, sized or not.
+void* operator new(std::size_t size) { return countedAllocate(size, 0); }
+void* operator new[](std::size_t size) { return countedAllocate(size, 0); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return countedAllocate(size, 0); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return countedAllocate(size, 0); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return countedAllocate(size, static_cast<std::size_t>(alignment)); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return countedAllocate(size, static_cast<std::size_t>(alignment)); }
+    catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+
+#endif
+
+namespace AllocationCounter {
+
+    uint64_t getThreadCount()
+    {
+        return threadAllocations;
+    }
+
+    uint64_t getTotalCount()
+    {
+        return totalAllocations.load(std::memory_order_relaxed);
+    }
+
+    bool isEnabled()
+    {
+#ifdef OPENENGINE_NO_ALLOCATION_COUNTER
+        return false;
+#else
+        return true;
+#endif
+    }
+
+} // namespace AllocationCounter
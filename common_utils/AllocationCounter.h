@@ -0,0 +1,38 @@
+#pragma once
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+// Counts calls into the global operator new (AllocationCounter.cpp
+// replaces every form, aligned and array ones included), per thread
+// and process-wide. Used to check that the per-frame animation path
+// runs without touching the heap; FrameArena blocks count as ordinary
+// allocations when they are created.
+//
+// Define OPENENGINE_NO_ALLOCATION_COUNTER to keep the standard
+// operator new; the counters then stay at zero.
+namespace AllocationCounter {
+
+    // Allocations made by the calling thread since it started
+    uint64_t getThreadCount();
+
+    // Allocations made by every thread since startup
+    uint64_t getTotalCount();
+
+    // False when built with OPENENGINE_NO_ALLOCATION_COUNTER
+    bool isEnabled();
+
+    // Allocations made by the calling thread while it is alive
+    class Scope {
+    public:
+        Scope() : start(getThreadCount()) {}
+        uint64_t getCount() const { return getThreadCount() - start; }
+
+    private:
+        uint64_t start;
+    };
+
+} // namespace AllocationCounter
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,87 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t initialCapacity)
+{
+    addBlock(std::max<size_t>(initialCapacity, 256));
+}
+
+void FrameArena::addBlock(size_t minBytes)
+{
+    const size_t size = blocks.empty() ? minBytes : std::max(minBytes, blocks.back().size);
+
+    Block block;
+    block.data.reset(new unsigned char[size]);
+    block.size = size;
+    blocks.push_back(std::move(block));
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment)
+{
+    for (;;)
+    {
+        const Block& block = blocks[current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        const uintptr_t start = (base + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        const size_t end = static_cast<size_t>(start - base) + bytes;
+
+        if (end <= block.size)
+        {
+            used += end - offset;
+            offset = end;
+            highWater = std::max(highWater, used);
+            return block.data.get() + (start - base);
+        }
+
+        // Doesn't fit: the rest of this block is wasted for the frame and
+        // counted, so reset() sizes the merged block for it too
+        used += block.size - offset;
+        if (current + 1 == blocks.size())
+            addBlock(bytes + alignment);
+        ++current;
+        offset = 0;
+    }
+}
+
+void FrameArena::reset()
+{
+    if (blocks.size() > 1)
+    {
+        const size_t size = highWater + highWater / 2;
+        blocks.clear();
+        addBlock(size);
+    }
+
+    current = 0;
+    offset = 0;
+    used = 0;
+    highWater = 0;
+}
+
+size_t FrameArena::getCapacity() const
+{
+    size_t total = 0;
+    for (const Block& block : blocks)
+        total += block.size;
+    return total;
+}
+
+FrameArena& FrameArena::forThisThread()
+{
+    thread_local FrameArena arena;
+    return arena;
+}
+
+FrameArena::Scope::Scope(FrameArena& arena)
+    : arena(arena), block(arena.current), offset(arena.offset), used(arena.used)
+{
+}
+
+FrameArena::Scope::~Scope()
+{
+    arena.current = block;
+    arena.offset = offset;
+    arena.used = used;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Linear allocator for scratch that lives no longer than one frame.
+// allocate() bumps a pointer through one block and reset() releases
+// everything at once. A frame that outgrows the block spills into extra
+// heap blocks; the next reset() swaps them all for a single block sized
+// for that frame, so a steady workload stops touching the heap after
+// its first few frames.
+//
+// Nothing is destroyed on reset, so only trivially destructible types
+// belong here. An arena is not thread-safe: give each owner or thread
+// its own (see forThisThread()).
+class FrameArena {
+public:
+    explicit FrameArena(size_t initialCapacity = 64 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    // Uninitialised storage for count Ts
+    template <typename T>
+    T* allocateArray(size_t count);
+
+    // Drops every allocation made since the last reset
+    void reset();
+
+    // Hands back everything allocated after construction when it goes
+    // out of scope; for scratch taken mid-frame from a shared arena.
+    class Scope {
+    public:
+        explicit Scope(FrameArena& arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameArena& arena;
+        size_t block;
+        size_t offset;
+        size_t used;
+    };
+
+    size_t getBytesUsed() const { return used; }
+    size_t getHighWater() const { return highWater; }
+    size_t getCapacity() const;
+
+    // Arena private to the calling thread, for callers without a frame
+    // owner of their own; pair every use with a Scope.
+    static FrameArena& forThisThread();
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size = 0;
+    };
+
+    void addBlock(size_t minBytes);
+
+    std::vector<Block> blocks;
+    size_t current = 0;     // block being bumped
+    size_t offset = 0;      // bytes taken from blocks[current]
+    size_t used = 0;        // bytes taken this frame, padding included
+    size_t highWater = 0;   // largest `used` since the last reset
+};
+
+template <typename T>
+T* FrameArena::allocateArray(size_t count)
+{
+    static_assert(std::is_trivially_destructible<T>::value,
+        "FrameArena never runs destructors");
+    return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+}
+
+#endif // FRAMEARENA_H
@@ -0,0 +1,414 @@
+#include "LogSink.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    struct LogRecord
+    {
+        uint64_t timeMicros = 0;        // since the sink started
+        Logger::Level level = Logger::INFO;
+        Logger::Category category = Logger::General;
+        std::string text;
+    };
+
+    // Bounded MPSC ring (Vyukov): each cell's sequence says whose turn it
+    // is. A producer claims a slot with one CAS on enqueuePos and publishes
+    // it with a release store; the single consumer needs no atomics of its
+    // own beyond the cell sequences.
+    class RecordRing
+    {
+    public:
+        explicit RecordRing(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+            cells = std::make_unique<Cell[]>(size);
+            mask = size - 1;
+            for (size_t i = 0; i < size; ++i)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        bool tryPush(LogRecord& record)
+        {
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;)
+            {
+                cell = &cells[pos & mask];
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;   // full
+                else
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+
+            cell->record = std::move(record);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side; one thread at a time
+        bool tryPop(LogRecord& out)
+        {
+            Cell& cell = cells[dequeuePos & mask];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (seq != dequeuePos + 1)
+                return false;       // empty, or the producer hasn't published yet
+
+            out = std::move(cell.record);
+            cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+            ++dequeuePos;
+            return true;
+        }
+
+        size_t claimed() const { return enqueuePos.load(std::memory_order_acquire); }
+        size_t consumed() const { return dequeuePos; }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence{ 0 };
+            LogRecord record;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        size_t mask = 0;
+        alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+        alignas(64) size_t dequeuePos = 0;
+    };
+
+    struct SinkState
+    {
+        explicit SinkState(const LogSink::Config& config)
+            : config(config), ring(config.capacity) {}
+
+        LogSink::Config config;
+        RecordRing ring;
+        std::ofstream file;
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+        std::thread writer;
+        std::atomic<bool> stopping{ false };
+        std::atomic<bool> writerIdle{ false };
+        std::mutex wakeMutex;
+        std::condition_variable wake;
+
+        // Held by whoever is draining the ring: the writer, or a crash handler
+        std::atomic_flag consumerBusy = ATOMIC_FLAG_INIT;
+
+        std::atomic<size_t> written{ 0 };       // ring position fully written and flushed
+        std::mutex flushMutex;
+        std::condition_variable flushed;
+
+        std::atomic<uint64_t> dropped{ 0 };
+        uint64_t droppedReported = 0;
+
+        std::string consoleOut, consoleErr, fileOut;   // per-batch buffers
+    };
+
+    std::atomic<SinkState*> activeSink{ nullptr };
+
+    const char* levelPrefix(Logger::Level level)
+    {
+        switch (level) {
+        case Logger::DEBUG:   return "DEBUG: ";
+        case Logger::INFO:    return "INFO: ";
+        case Logger::WARNING: return "WARNING: ";
+        case Logger::ERROR:   return "ERROR: ";
+        }
+        return "";
+    }
+
+    void formatRecord(SinkState& sink, const LogRecord& record)
+    {
+        if (sink.config.toConsole)
+        {
+            std::string& out = (record.level >= Logger::WARNING) ? sink.consoleErr : sink.consoleOut;
+            out += levelPrefix(record.level);
+            out += record.text;
+            out += '\n';
+        }
+
+        if (sink.file.is_open())
+        {
+            char stamp[48];
+            std::snprintf(stamp, sizeof(stamp), "[%11.6f] [%s] ",
+                record.timeMicros / 1e6, Logger::getCategoryName(record.category));
+            sink.fileOut += stamp;
+            sink.fileOut += levelPrefix(record.level);
+            sink.fileOut += record.text;
+            sink.fileOut += '\n';
+        }
+    }
+
+    void writeBuffers(SinkState& sink)
+    {
+        if (!sink.consoleOut.empty())
+        {
+            std::cout.write(sink.consoleOut.data(), sink.consoleOut.size());
+            std::cout.flush();
+            sink.consoleOut.clear();
+        }
+        if (!sink.consoleErr.empty())
+        {
+            std::cerr.write(sink.consoleErr.data(), sink.consoleErr.size());
+            std::cerr.flush();
+            sink.consoleErr.clear();
+        }
+        if (!sink.fileOut.empty())
+        {
+            sink.file.write(sink.fileOut.data(), sink.fileOut.size());
+            sink.file.flush();
+            sink.fileOut.clear();
+        }
+    }
+
+    // Writes everything published so far; the caller holds consumerBusy
+    bool drain(SinkState& sink)
+    {
+        LogRecord record;
+        bool any = false;
+        size_t batched = 0;
+        while (sink.ring.tryPop(record))
+        {
+            formatRecord(sink, record);
+            any = true;
+
+            // keep the buffers bounded through a long backlog
+            if (++batched % 1024 == 0)
+                writeBuffers(sink);
+        }
+
+        const uint64_t dropped = sink.dropped.load(std::memory_order_relaxed);
+        if (dropped != sink.droppedReported)
+        {
+            LogRecord note;
+            note.level = Logger::WARNING;
+            note.text = std::to_string(dropped - sink.droppedReported) + " log records dropped (ring full)";
+            formatRecord(sink, note);
+            sink.droppedReported = dropped;
+            any = true;
+        }
+
+        if (any)
+            writeBuffers(sink);
+        return any;
+    }
+
+    void writerLoop(SinkState& sink)
+    {
+        for (;;)
+        {
+            while (sink.consumerBusy.test_and_set(std::memory_order_acquire))
+                std::this_thread::yield();
+            const bool wrote = drain(sink);
+            sink.written.store(sink.ring.consumed(), std::memory_order_release);
+            sink.consumerBusy.clear(std::memory_order_release);
+
+            if (wrote)
+            {
+                std::lock_guard<std::mutex> lock(sink.flushMutex);
+                sink.flushed.notify_all();
+                continue;
+            }
+
+            if (sink.stopping.load(std::memory_order_acquire)
+                && sink.ring.consumed() == sink.ring.claimed())
+                return;
+
+            // Producers only notify while we're idle; the timeout covers
+            // a record published between the check and the wait
+            std::unique_lock<std::mutex> lock(sink.wakeMutex);
+            sink.writerIdle.store(true, std::memory_order_release);
+            sink.wake.wait_for(lock, std::chrono::milliseconds(2));
+            sink.writerIdle.store(false, std::memory_order_release);
+        }
+    }
+
+    void wakeWriter(SinkState& sink)
+    {
+        if (sink.writerIdle.load(std::memory_order_acquire))
+            sink.wake.notify_one();
+    }
+
+    // Best effort from a dying thread: take over the consumer role (the
+    // writer may be mid-batch, so give it a moment) and write what's
+    // queued. The ring has a single consumer, so if the writer never lets
+    // go the tail is abandoned and only a note goes out, straight to stderr.
+    void crashFlush()
+    {
+        SinkState* sink = activeSink.load(std::memory_order_acquire);
+        if (!sink)
+            return;
+
+        for (int i = 0; i < 200; ++i)
+        {
+            if (!sink->consumerBusy.test_and_set(std::memory_order_acquire))
+            {
+                drain(*sink);
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::fputs("LogSink: log tail lost (writer busy at crash)\n", stderr);
+        std::fflush(stderr);
+    }
+
+    std::terminate_handler previousTerminate = nullptr;
+
+    void onTerminate()
+    {
+        crashFlush();
+        if (previousTerminate)
+            previousTerminate();
+        std::abort();
+    }
+
+    extern "C" void onFatalSignal(int signal)
+    {
+        crashFlush();
+        std::signal(signal, SIG_DFL);
+        std::raise(signal);
+    }
+
+    void installCrashHandlers()
+    {
+        static bool installed = false;
+        if (installed)
+            return;
+        installed = true;
+
+        previousTerminate = std::set_terminate(onTerminate);
+        for (int signal : { SIGSEGV, SIGABRT, SIGFPE, SIGILL })
+            std::signal(signal, onFatalSignal);
+        std::atexit(LogSink::stop);
+    }
+
+} // namespace
+
+
+bool LogSink::start(const Config& config)
+{
+    if (activeSink.load(std::memory_order_acquire))
+        return false;
+
+    auto sink = std::make_unique<SinkState>(config);
+    if (!config.filePath.empty())
+    {
+        sink->file.open(config.filePath, std::ios::out | std::ios::trunc);
+        if (!sink->file.is_open())
+        {
+            Logger::log("LogSink: cannot open " + config.filePath, Logger::ERROR);
+            return false;
+        }
+    }
+
+    SinkState* state = sink.release();
+    state->writer = std::thread([state]() { writerLoop(*state); });
+    activeSink.store(state, std::memory_order_release);
+
+    installCrashHandlers();
+    return true;
+}
+
+void LogSink::stop()
+{
+    SinkState* sink = activeSink.exchange(nullptr, std::memory_order_acq_rel);
+    if (!sink)
+        return;
+
+    sink->stopping.store(true, std::memory_order_release);
+    sink->wake.notify_one();
+    if (sink->writer.joinable())
+        sink->writer.join();
+
+    {
+        std::lock_guard<std::mutex> lock(sink->flushMutex);
+        sink->flushed.notify_all();
+    }
+
+    // Producers that loaded the pointer before the exchange may still be
+    // pushing, so the state is never freed
+    sink->file.close();
+}
+
+void LogSink::flush()
+{
+    SinkState* sink = activeSink.load(std::memory_order_acquire);
+    if (!sink)
+        return;
+
+    const size_t target = sink->ring.claimed();
+    sink->wake.notify_one();
+
+    std::unique_lock<std::mutex> lock(sink->flushMutex);
+    sink->flushed.wait(lock, [&]() {
+        return sink->written.load(std::memory_order_acquire) >= target
+            || !activeSink.load(std::memory_order_acquire);
+        });
+}
+
+bool LogSink::isRunning()
+{
+    return activeSink.load(std::memory_order_acquire) != nullptr;
+}
+
+uint64_t LogSink::getDroppedCount()
+{
+    SinkState* sink = activeSink.load(std::memory_order_acquire);
+    return sink ? sink->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+bool LogSink::push(Logger::Level level, Logger::Category category, std::string&& text)
+{
+    SinkState* sink = activeSink.load(std::memory_order_acquire);
+    if (!sink)
+        return false;
+
+    LogRecord record;
+    record.timeMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - sink->startTime).count());
+    record.level = level;
+    record.category = category;
+    record.text = std::move(text);
+
+    while (!sink->ring.tryPush(record))
+    {
+        if (sink->stopping.load(std::memory_order_acquire))
+        {
+            text = std::move(record.text);  // writer is gone; caller writes it
+            return false;
+        }
+        if (sink->config.overflow == Overflow::Drop)
+        {
+            sink->dropped.fetch_add(1, std::memory_order_relaxed);
+            wakeWriter(*sink);
+            return true;
+        }
+        sink->wake.notify_one();
+        std::this_thread::yield();
+    }
+
+    wakeWriter(*sink);
+    return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Logger.h"
+
+// Asynchronous back end for Logger. Records (timestamp, level, category,
+// formatted text) go into a bounded lock-free multi-producer ring and a
+// dedicated writer thread drains them to the console and/or a file in
+// batches. While the sink is not running Logger writes synchronously.
+//
+// The ring is flushed by flush(), by stop() (also registered with
+// atexit), and on a fatal signal or std::terminate, where the crashing
+// thread drains whatever is queued before the process goes down.
+class LogSink {
+public:
+    enum class Overflow {
+        Drop,       // lose the record, counted and reported by the writer
+        Block       // wait for the writer to make room
+    };
+
+    struct Config {
+        size_t capacity = 8192;         // records; rounded up to a power of two
+        Overflow overflow = Overflow::Block;
+        bool toConsole = true;          // INFO/DEBUG on stdout, WARNING/ERROR on stderr
+        std::string filePath;           // empty: no log file
+    };
+
+    // Starts the writer thread; false if already running or the file
+    // cannot be opened
+    static bool start(const Config& config);
+
+    // Drains and joins the writer; later records are written synchronously
+    static void stop();
+
+    // Returns once every record queued before the call has been written
+    static void flush();
+
+    static bool isRunning();
+    static uint64_t getDroppedCount();
+
+    // Called by Logger::write. Takes text unless it returns false (sink
+    // not running), in which case the caller writes it itself.
+    static bool push(Logger::Level level, Logger::Category category, std::string&& text);
+};
+
+#endif // LOGSINK_H
@@ -1,27 +1,69 @@
 #include "Logger.h"
+#include "LogSink.h"
+
+#include <mutex>
+
+// One line at a time - clips are loaded from several threads
+static std::mutex logMutex;
 
 void Logger::log(const std::string& message, Level level) {
+    if (isEnabled(level))
+        write(message, level);
+}
+
+void Logger::log(std::string&& message, Level level) {
+    if (isEnabled(level))
+        write(std::move(message), level);
+}
+
+void Logger::log(const char* message, Level level) {
+    if (isEnabled(level))
+        write(message, level);
+}
+
+void Logger::write(const std::string& message, Level level, Category category) {
+    if (LogSink::isRunning())
+        write(std::string(message), level, category);
+    else
+        writeNow(message.c_str(), level);
+}
+
+void Logger::write(std::string&& message, Level level, Category category) {
+    if (!LogSink::push(level, category, std::move(message)))
+        writeNow(message.c_str(), level);
+}
+
+void Logger::write(const char* message, Level level, Category category) {
+    if (LogSink::isRunning())
+        write(std::string(message), level, category);
+    else
+        writeNow(message, level);
+}
+
+const char* Logger::getCategoryName(Category category) {
+    switch (category) {
+    case General:   return "General";
+    case Animation: return "Animation";
+    case Model:     return "Model";
+    case Render:    return "Render";
+    default:        return "Mixed";
+    }
+}
+
+void Logger::writeNow(const char* message, Level level) {
+    std::lock_guard<std::mutex> lock(logMutex);
     switch (level) {
+    case DEBUG:
+        std::cout << "DEBUG: " << message << std::endl;
+        break;
     case INFO:
-        logInfo(message);
+        std::cout << "INFO: " << message << std::endl;
         break;
     case WARNING:
-        logWarning(message);
+        std::cerr << "WARNING: " << message << std::endl;
         break;
     case ERROR:
-        logError(message);
+        std::cerr << "ERROR: " << message << std::endl;
         break;
     }
 }
-
-void Logger::logInfo(const std::string& message) {
-    std::cout << "INFO: " << message << std::endl;
-}
-
-void Logger::logWarning(const std::string& message) {
-    std::cerr << "WARNING: " << message << std::endl;
-}
-
-void Logger::logError(const std::string& message) {
-    std::cerr << "ERROR: " << message << std::endl;
-}
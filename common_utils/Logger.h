@@ -2,6 +2,7 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
 #include <iostream>
 #include <string>
 
@@ -14,12 +15,90 @@ public:
         ERROR
     };
 
+    // Subsystems for the LOG_* macros, one bit each for setCategories()
+    enum Category : unsigned {
+        General   = 1u << 0,
+        Animation = 1u << 1,
+        Model     = 1u << 2,
+        Render    = 1u << 3,
+        AllCategories = ~0u
+    };
+
+    // Writes unless level is below the runtime level (General category)
     static void log(const std::string& message, Level level = INFO);
+    static void log(std::string&& message, Level level = INFO);
+
+    // Same, without building a std::string (per-frame callers)
+    static void log(const char* message, Level level = INFO);
+
+    // Unfiltered; for callers that already checked isEnabled(). Goes
+    // through LogSink when it is running, straight to the console if not.
+    static void write(const std::string& message, Level level, Category category = General);
+    static void write(std::string&& message, Level level, Category category = General);
+    static void write(const char* message, Level level, Category category = General);
+
+    static const char* getCategoryName(Category category);
+
+    // Runtime filter, INFO and every category by default. The LOG_*
+    // macros check it before building their message.
+    static void setLevel(Level level) { minLevel.store(level, std::memory_order_relaxed); }
+    static Level getLevel() { return minLevel.load(std::memory_order_relaxed); }
+    static void setCategories(unsigned mask) { categoryMask.store(mask, std::memory_order_relaxed); }
+    static unsigned getCategories() { return categoryMask.load(std::memory_order_relaxed); }
+
+    static bool isEnabled(Level level, Category category = General) {
+        return level >= getLevel() && (getCategories() & category) != 0;
+    }
 
 private:
-    static void logInfo(const std::string& message);
-    static void logWarning(const std::string& message);
-    static void logError(const std::string& message);
+    static void writeNow(const char* message, Level level);
+
+    inline static std::atomic<Level> minLevel{ INFO };
+    inline static std::atomic<unsigned> categoryMask{ AllCategories };
 };
 
+/* Level- and category-gated logging. The message expression is only
+   evaluated when the call passes the runtime filter, and levels below
+   LOG_COMPILE_LEVEL (0 DEBUG .. 3 ERROR) are not compiled in at all:
+
+       LOG_DEBUG(Logger::Animation, "frame " + std::to_string(i));
+
+   LOG_ENABLED guards diagnostics that need more than one call; below
+   the compile-time level it is a constant false.                      */
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 0
+#endif
+
+#define LOG_ENABLED(level, category) \
+    ((level) >= LOG_COMPILE_LEVEL && Logger::isEnabled((level), (category)))
+
+#define LOGGER_EMIT(level, category, message)       \
+    do {                                            \
+        if (Logger::isEnabled((level), (category))) \
+            Logger::write((message), (level), (category)); \
+    } while (0)
+
+#define LOGGER_DISCARD(message) \
+    do { if (false) { (void)(message); } } while (0)
+
+#if LOG_COMPILE_LEVEL <= 0
+#define LOG_DEBUG(category, message) LOGGER_EMIT(Logger::DEBUG, category, message)
+#else
+#define LOG_DEBUG(category, message) LOGGER_DISCARD(message)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 1
+#define LOG_INFO(category, message) LOGGER_EMIT(Logger::INFO, category, message)
+#else
+#define LOG_INFO(category, message) LOGGER_DISCARD(message)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 2
+#define LOG_WARNING(category, message) LOGGER_EMIT(Logger::WARNING, category, message)
+#else
+#define LOG_WARNING(category, message) LOGGER_DISCARD(message)
+#endif
+
+#define LOG_ERROR(category, message) LOGGER_EMIT(Logger::ERROR, category, message)
+
 #endif // LOGGER_H
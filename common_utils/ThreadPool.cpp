@@ -0,0 +1,123 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if (threadCount == 0)
+    {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 1 ? hw - 1 : 1;
+    }
+
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        workers.emplace_back([this]() { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.push(std::move(task));
+    }
+    queueReady.notify_one();
+}
+
+void ThreadPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+    if (count == 0)
+        return;
+
+    if (count == 1 || workers.empty())
+    {
+        for (size_t i = 0; i < count; ++i)
+            body(i);
+        return;
+    }
+
+    // Helpers that start after the last index was claimed find nothing
+    // to do and never touch body, so it can live on the caller's stack
+    struct Batch {
+        const std::function<void(size_t)>* body = nullptr;
+        size_t count = 0;
+        std::atomic<size_t> next{ 0 };
+        std::atomic<size_t> finished{ 0 };
+        std::mutex doneMutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->body = &body;
+    batch->count = count;
+
+    auto drain = [batch]() {
+        size_t ran = 0;
+        for (size_t i = batch->next.fetch_add(1); i < batch->count; i = batch->next.fetch_add(1))
+        {
+            try {
+                (*batch->body)(i);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(batch->doneMutex);
+                if (!batch->error)
+                    batch->error = std::current_exception();
+            }
+            ++ran;
+        }
+
+        if (ran > 0 && batch->finished.fetch_add(ran) + ran == batch->count)
+        {
+            std::lock_guard<std::mutex> lock(batch->doneMutex);
+            batch->done.notify_all();
+        }
+    };
+
+    const size_t helpers = std::min(count - 1, workers.size());
+    for (size_t h = 0; h < helpers; ++h)
+        enqueue(drain);
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(batch->doneMutex);
+    batch->done.wait(lock, [&]() { return batch->finished.load() == count; });
+    if (batch->error)
+        std::rethrow_exception(batch->error);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads fed from one FIFO queue.
+class ThreadPool {
+public:
+    // threadCount 0: one worker per hardware thread, minus the caller
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& task) -> std::future<decltype(task())>;
+
+    // Runs body(i) for every i in [0, count) and returns when all are
+    // done. The calling thread takes indices too, so nested calls from
+    // inside pool tasks cannot deadlock. The first exception thrown by
+    // body is rethrown here once every index has finished.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()); }
+
+    // Process-wide pool shared by the loaders and the per-frame work
+    static ThreadPool& shared();
+
+private:
+    void enqueue(std::function<void()> task);
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    bool stopping = false;
+};
+
+template <typename F>
+auto ThreadPool::submit(F&& task) -> std::future<decltype(task())>
+{
+    using Result = decltype(task());
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    std::future<Result> result = packaged->get_future();
+
+    if (workers.empty())
+        (*packaged)();
+    else
+        enqueue([packaged]() { (*packaged)(); });
+    return result;
+}
+
+#endif // THREADPOOL_H
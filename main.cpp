@@ -2,6 +2,7 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include "common_utils/Logger.h"
+#include "common_utils/LogSink.h"
 #include "input/InputManager.h"
 #include "model/Camera.h"
 #include "shaders/ShaderManager.h"
@@ -16,6 +17,13 @@
 #include "setup/GraphicsSetup.h"
 #include "setup/InputCallbacks.h"
 #include "scene/SceneTest3.h"
+#include "scene/SceneTest4.h"
+#include "animation/JitterTuner.h"
+#include "animation/PoseDiff.h"
+#include "animation/PoseDump.h"
+#include "model/Model.h"
+#include <cstdlib>
+#include <cstring>
 
 // Cube and Plane VAOs and VBOs
 unsigned int cubeVAO, cubeVBO;
@@ -31,7 +39,68 @@ void windowCloseCallback(GLFWwindow* window) {
     glfwSetWindowShouldClose(window, GLFW_TRUE);
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // --tune-jitter: sweep the jitter thresholds, write jitter_config.json, exit
+    bool tuneJitter = false;
+    for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], "--tune-jitter") == 0)
+            tuneJitter = true;
+
+    // --pose-dump-json <in.posedump> <out.json>: convert a pose dump for
+    // the JSON-reading tools, exit
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--pose-dump-json") == 0)
+        {
+            if (i + 2 >= argc) {
+                std::cerr << "usage: --pose-dump-json <in.posedump> <out.json>" << std::endl;
+                return 1;
+            }
+            return PoseDump::toJson(argv[i + 1], argv[i + 2]) ? 0 : 1;
+        }
+    }
+
+    // --pose-diff <reference> <engine> [--max-translation u] [--max-angle-deg d] [--top n]:
+    // compare pose dumps (or two directories of them), exit 1 past the limits
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--pose-diff") == 0)
+        {
+            if (i + 2 >= argc) {
+                std::cerr << "usage: --pose-diff <reference> <engine> [--max-translation u] [--max-angle-deg d] [--top n]" << std::endl;
+                return 2;
+            }
+            PoseDiffOptions options;
+            for (int j = i + 3; j + 1 < argc; j += 2)
+            {
+                if (std::strcmp(argv[j], "--max-translation") == 0)
+                    options.maxTranslation = std::strtof(argv[j + 1], nullptr);
+                else if (std::strcmp(argv[j], "--max-angle-deg") == 0)
+                    options.maxAngleDeg = std::strtof(argv[j + 1], nullptr);
+                else if (std::strcmp(argv[j], "--top") == 0)
+                    options.top = std::strtoul(argv[j + 1], nullptr, 10);
+            }
+            return PoseDiff::run(argv[i + 1], argv[i + 2], options);
+        }
+    }
+
+    // --crowd [count]: run the crowd stress scene instead of SceneTest3
+    int crowdCount = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--crowd") == 0)
+        {
+            crowdCount = 64;
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+                crowdCount = std::atoi(argv[i + 1]);
+        }
+    }
+
+    // Logging goes through the background writer: console plus a file
+    LogSink::Config logConfig;
+    logConfig.filePath = "logs/engine.log";
+    LogSink::start(logConfig);
+
     // Initialize GLFW
     if (!glfwInit()) {
         Logger::log("Failed to initialize GLFW.", Logger::ERROR);
@@ -42,6 +111,8 @@ int main() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_COMPAT_PROFILE);
+    if (tuneJitter)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);   // the model's meshes still need a context
 
     // Create the window
     GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGL Game Engine", nullptr, nullptr);
@@ -61,6 +132,18 @@ int main() {
         return -1;
     }
 
+    if (tuneJitter) {
+        int result;
+        {
+            Model model("CharacterModelTPose w shorts.fbx");
+            result = JitterTuner::runHeadless(&model);
+        }
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        LogSink::stop();
+        return result;
+    }
+
     // Initialize ImGui (only once)
     Renderer::InitializeImGui(window);
 
@@ -77,7 +160,10 @@ int main() {
     physicsManager.Initialize();
 
     // Run the scene
-    SceneTest3(window);
+    if (crowdCount > 0)
+        SceneTest4(window, crowdCount);
+    else
+        SceneTest3(window);
 
     // Shutdown ImGui
     Renderer::ShutdownImGui();
@@ -86,5 +172,6 @@ int main() {
     glfwDestroyWindow(window);
     glfwTerminate();
 
+    LogSink::stop();
     return 0;
 }
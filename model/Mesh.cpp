@@ -81,7 +81,7 @@ void Mesh::setupMesh() {
 }
 
 void Mesh::Draw(Shader& shader) {
-    Logger::log("Drawing mesh with VAO: " + std::to_string(VAO), Logger::INFO);
+    LOG_DEBUG(Logger::Render, "Drawing mesh with VAO: " + std::to_string(VAO));
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
@@ -5,6 +5,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include "../common_utils/Logger.h"
+#include "../common_utils/FrameArena.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/string_cast.hpp> 
 #include "../animation/SkeletonPose.h"
@@ -95,6 +96,37 @@ void Model::loadModel(const std::string& path) {
 
     updateBoneHierarchy(scene->mRootNode, "");
     Logger::log("Bone hierarchy successfully built from scene graph.", Logger::INFO);
+
+    // Resolve parents and local bind poses by index once, so per-frame
+    // pose code never has to look a bone up by name.
+    boneLocalBindPoses.resize(bones.size());
+    boneOffsets.resize(bones.size());
+    for (size_t i = 0; i < bones.size(); ++i) {
+        bones[i].parentIndex = getBoneIndex(bones[i].parentName);
+        boneLocalBindPoses[i] = getLocalBindPose(bones[i].name);
+        boneOffsets[i] = bones[i].offsetMatrix;
+    }
+    skinPalette.assign(bones.size(), glm::mat4(1.0f));
+
+    // Parents ahead of children (breadth first from the roots), so a
+    // global pose is a single forward pass over boneOrder
+    std::vector<std::vector<int>> children(bones.size());
+    boneOrder.clear();
+    boneOrder.reserve(bones.size());
+    for (size_t i = 0; i < bones.size(); ++i) {
+        if (bones[i].parentIndex >= 0)
+            children[bones[i].parentIndex].push_back(static_cast<int>(i));
+        else
+            boneOrder.push_back(static_cast<int>(i));
+    }
+    for (size_t k = 0; k < boneOrder.size(); ++k)
+        for (int child : children[boneOrder[k]])
+            boneOrder.push_back(child);
+
+    if (boneOrder.size() != bones.size())
+        Logger::log("ERROR: Bone hierarchy has a cycle; " +
+            std::to_string(bones.size() - boneOrder.size()) + " bones left out of the pose order", Logger::ERROR);
+
     // ------------------------------------------------------------
 // 4.  Build a bind-pose snapshot for fast access during skinning
 // ------------------------------------------------------------
@@ -222,44 +254,73 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
 
 void Model::Draw(Shader& shader)
 {
-    std::vector<glm::mat4> finalMatrices(bones.size(), glm::mat4(1.0f));
-
-#ifdef VERBOSE_SKINNING_DUMP     // <-- add a compile-time guard
-    Logger::log("Bone [" + bones[i].name + "] FINAL TRANSFORM:", Logger::INFO);
-    Logger::log(glm::to_string(bones[i].finalTransform), Logger::INFO);
-#endif
-
-    for (size_t i = 0; i < bones.size(); i++) {
-        glm::mat4 globalTransform = getBoneTransform(bones[i].name);
-
-        // Combine with offset matrix to move from bind pose to animated pose
-        bones[i].finalTransform = globalTransform;
-        finalMatrices[i] = bones[i].finalTransform;
-
-        // Debug output (optional)
-        Logger::log("Bone [" + bones[i].name + "] FINAL TRANSFORM:", Logger::INFO);
-        Logger::log(glm::to_string(bones[i].finalTransform), Logger::INFO);
-
-        glm::vec3 scale, translation, skew;
-        glm::quat rotation;
-        glm::vec4 perspective;
-        glm::decompose(bones[i].finalTransform, scale, rotation, translation, skew, perspective);
-        Logger::log("Bone: " + bones[i].name +
-            " Scale: " + glm::to_string(scale) +
-            " Translation: " + glm::to_string(translation) +
-            " Skew: " + glm::to_string(skew), Logger::INFO);
-
-        DebugTools::logDecomposedTransform(bones[i].name, bones[i].finalTransform);
+    // Per-bone palette dump; compiled out below LOG_COMPILE_LEVEL 0
+    if (LOG_ENABLED(Logger::DEBUG, Logger::Render)) {
+        for (size_t i = 0; i < bones.size(); i++) {
+            Logger::write("Bone [" + bones[i].name + "] FINAL TRANSFORM:", Logger::DEBUG);
+            Logger::write(glm::to_string(getSkinPalette()[i]), Logger::DEBUG);
+
+            glm::vec3 scale, translation, skew;
+            glm::quat rotation;
+            glm::vec4 perspective;
+            glm::decompose(getSkinPalette()[i], scale, rotation, translation, skew, perspective);
+            Logger::write("Bone: " + bones[i].name +
+                " Scale: " + glm::to_string(scale) +
+                " Translation: " + glm::to_string(translation) +
+                " Skew: " + glm::to_string(skew), Logger::DEBUG);
+
+            DebugTools::logDecomposedTransform(bones[i].name, getSkinPalette()[i]);
+        }
     }
 
     shader.use();
-    shader.setMat4Array("boneTransforms", finalMatrices);
+
+    // The palette goes up as-is; the uniform is looked up once per program
+    if (shader.ID != paletteProgram) {
+        paletteProgram = shader.ID;
+        paletteLocation = shader.getUniformLocation("boneTransforms");
+        if (paletteLocation == -1)
+            Logger::log("Uniform boneTransforms not found in shader.", Logger::ERROR);
+    }
+    shader.setMat4Array(paletteLocation, getSkinPalette(), skinPalette.size());
 
     for (auto& mesh : meshes)
         mesh.Draw(shader);
 }
 
 
+void Model::updateSkinPalette(const glm::mat4* globalPose, size_t count)
+{
+    detachSkinPalette();
+    computeSkinPalette(globalPose, std::min(count, skinPalette.size()), skinPalette.data());
+}
+
+void Model::computeSkinPalette(const glm::mat4* globalPose, size_t count, glm::mat4* outPalette) const
+{
+    count = std::min(count, boneOffsets.size());
+    for (size_t i = 0; i < count; ++i)
+        outPalette[i] = globalInverseTransform * globalPose[i] * boneOffsets[i];
+}
+
+void Model::useSkinPalette(const glm::mat4* palette)
+{
+    if (palette)
+        externalPalette = palette;
+    else
+        detachSkinPalette();
+}
+
+// Back to the model's own palette, starting from the borrowed one so
+// that partial writes land on the pose being shown
+void Model::detachSkinPalette()
+{
+    if (!externalPalette)
+        return;
+    std::copy(externalPalette, externalPalette + skinPalette.size(), skinPalette.begin());
+    externalPalette = nullptr;
+}
+
+
 
 glm::vec3 Model::getBoundingBoxCenter() const {
     glm::vec3 min(FLT_MAX), max(-FLT_MAX);
@@ -304,14 +365,30 @@ const std::unordered_map<std::string, glm::mat4>& Model::getBoneTransforms() con
 
 const glm::mat4& Model::getBoneTransform(const std::string& boneName) const {
     static const glm::mat4 identity = glm::mat4(1.0f);
+    int index = getBoneIndex(boneName);
+    if (index >= 0)
+        return getSkinPalette()[index];
     auto it = boneTransforms.find(boneName);
     return it != boneTransforms.end() ? it->second : identity;
 }
 
 
 void Model::setBoneTransform(const std::string& boneName, const glm::mat4& transform) {
-    boneTransforms[boneName] = transform;
-    Logger::log("DEBUG: After Storing Bone " + boneName, Logger::INFO);
+    int index = getBoneIndex(boneName);
+    if (index >= 0) {
+        detachSkinPalette();
+        skinPalette[index] = transform;
+    }
+    else
+        boneTransforms[boneName] = transform;   // not a skinned bone, keep it by name
+    LOG_DEBUG(Logger::Model, "After Storing Bone " + boneName);
+}
+
+void Model::setBoneTransform(int boneIndex, const glm::mat4& transform) {
+    if (boneIndex >= 0 && boneIndex < static_cast<int>(skinPalette.size())) {
+        detachSkinPalette();
+        skinPalette[boneIndex] = transform;
+    }
 }
 
 
@@ -319,12 +396,29 @@ void Model::setBoneTransform(const std::string& boneName, const glm::mat4& trans
 
 
 std::string Model::getBoneParent(const std::string& boneName) const {
-    for (const auto& bone : bones) {
-        if (bone.name == boneName) {
-            return bone.parentName;
-        }
+    int index = getBoneIndex(boneName);
+    return (index >= 0) ? bones[index].parentName : "";
+}
+
+
+// One forward pass over boneOrder: every parent is final before its
+// children read it. Roots are parented to rootParent.
+void Model::computeGlobalPose(const std::vector<glm::mat4>& localPose,
+    std::vector<glm::mat4>& globalPose,
+    const glm::mat4& rootParent) const
+{
+    globalPose.resize(bones.size());
+    computeGlobalPose(localPose.data(), globalPose.data(), rootParent);
+}
+
+void Model::computeGlobalPose(const glm::mat4* localPose,
+    glm::mat4* globalPose,
+    const glm::mat4& rootParent) const
+{
+    for (int i : boneOrder) {
+        int parent = bones[i].parentIndex;
+        globalPose[i] = (parent >= 0 ? globalPose[parent] : rootParent) * localPose[i];
     }
-    return "";
 }
 
 void Model::forceTestBoneTransform() {
@@ -398,62 +492,35 @@ void Model::updateBoneHierarchy(const aiNode* node, const std::string& parentNam
 }
 
 
-// This is the key function for recursively accumulating bone transforms
+// Global transform of one bone from name-keyed locals (bones without
+// one use identity). The first call fills globalTransforms for the whole
+// skeleton with one computeGlobalPose pass; later calls hit the cache.
 glm::mat4 Model::calculateBoneTransform(const std::string& boneName,
     const std::unordered_map<std::string, glm::mat4>& localTransforms,
     std::unordered_map<std::string, glm::mat4>& globalTransforms) {
 
-    // If already computed, return the cached transform.
     auto cached = globalTransforms.find(boneName);
-    if (cached != globalTransforms.end()) {
-        Logger::log("Using cached global transform for bone " + boneName, Logger::INFO);
+    if (cached != globalTransforms.end())
         return cached->second;
-    }
 
-    // Retrieve the local transform. Default to identity if not found.
-    glm::mat4 localTransform = glm::mat4(1.0f);
-    auto it = localTransforms.find(boneName);
-    if (it != localTransforms.end()) {
-        localTransform = it->second;
+    FrameArena::Scope scratch(FrameArena::forThisThread());
+    glm::mat4* localPose = FrameArena::forThisThread().allocateArray<glm::mat4>(bones.size());
+    glm::mat4* globalPose = FrameArena::forThisThread().allocateArray<glm::mat4>(bones.size());
+    for (size_t i = 0; i < bones.size(); ++i) {
+        auto it = localTransforms.find(bones[i].name);
+        localPose[i] = (it != localTransforms.end()) ? it->second : glm::mat4(1.0f);
     }
 
-    // Log local transform specifically for arm bones
-    if (boneName == "DEF-upper_arm.L" || boneName == "DEF-upper_arm.R") {
-        Logger::log("DEBUG: Arm bone [" + boneName + "] local transform: " + glm::to_string(localTransform), Logger::INFO);
-    }
+    computeGlobalPose(localPose, globalPose);
+    for (size_t i = 0; i < bones.size(); ++i)
+        globalTransforms.emplace(bones[i].name, globalPose[i]);
 
-    // Get the parent's name and recursively compute its global transform.
-    std::string parentName = getBoneParent(boneName);
-    glm::mat4 parentTransform = glm::mat4(1.0f);
-    if (!parentName.empty()) {
-        parentTransform = calculateBoneTransform(parentName, localTransforms, globalTransforms);
-        Logger::log("Bone [" + boneName + "] parent's (" + parentName + ") global transform: " + glm::to_string(parentTransform), Logger::INFO);
-    }
-    else {
-        Logger::log("Bone [" + boneName + "] has no parent; using identity for parent transform.", Logger::INFO);
-    }
-
-    // Compute final global transform
-    glm::mat4 finalTransform = parentTransform * localTransform;
-
-    // Log final global transform specifically for arm bones
-    if (boneName == "DEF-upper_arm.L" || boneName == "DEF-upper_arm.R") {
-        Logger::log("DEBUG: Arm bone [" + boneName + "] final global transform: " + glm::to_string(finalTransform), Logger::INFO);
-    }
-
-    globalTransforms[boneName] = finalTransform;
-    Logger::log("Bone [" + boneName + "] final computed transform: " + glm::to_string(finalTransform), Logger::INFO);
-    return finalTransform;
-}
-
-std::vector<glm::mat4> Model::getFinalBoneMatrices() const {
-    std::vector<glm::mat4> matrices;
-    matrices.reserve(bones.size());
-
-    for (const auto& bone : bones) {
-        matrices.push_back(bone.finalTransform);
-    }
-    return matrices;
+    // Not a skinned bone: it has no parent, so its global is its local
+    cached = globalTransforms.find(boneName);
+    if (cached != globalTransforms.end())
+        return cached->second;
+    auto local = localTransforms.find(boneName);
+    return (local != localTransforms.end()) ? local->second : glm::mat4(1.0f);
 }
 
 glm::mat4 Model::getBoneOffsetMatrix(const std::string& boneName) const {
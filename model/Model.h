@@ -21,8 +21,8 @@ class SkeletonPose;                   // correct forward declaration
 struct Bone {
     std::string name;
     std::string parentName;
+    int parentIndex = -1;                       // index into Model::bones, -1 for skeleton roots
     glm::mat4 offsetMatrix = glm::mat4(1.0f); // NEW: store the bone's offset (bind pose) matrix
-    glm::mat4 finalTransform = glm::mat4(1.0f); // Add this line
 
 };
 
@@ -37,6 +37,7 @@ public:
     const std::vector<Bone>& getBones() const;
     const std::unordered_map<std::string, glm::mat4>& getBoneTransforms() const;
     void setBoneTransform(const std::string& boneName, const glm::mat4& transform);
+    void setBoneTransform(int boneIndex, const glm::mat4& transform);
     int getBoneIndex(const std::string& boneName) const;
 
     // Added Method
@@ -50,7 +51,38 @@ public:
     glm::mat4 calculateBoneTransform(const std::string& boneName,
     const std::unordered_map<std::string, glm::mat4>& localTransforms,
         std::unordered_map<std::string, glm::mat4>& globalTransforms);
-    std::vector<glm::mat4> getFinalBoneMatrices() const;
+
+    // Bone indices in topological order: parents before children
+    const std::vector<int>& getBoneOrder() const { return boneOrder; }
+
+    // Local-to-global for the whole skeleton; both arrays indexed like
+    // getBones(). The pointer form expects getBones().size() entries in
+    // each, e.g. frame-arena scratch.
+    void computeGlobalPose(const std::vector<glm::mat4>& localPose,
+        std::vector<glm::mat4>& globalPose,
+        const glm::mat4& rootParent = glm::mat4(1.0f)) const;
+    void computeGlobalPose(const glm::mat4* localPose,
+        glm::mat4* globalPose,
+        const glm::mat4& rootParent = glm::mat4(1.0f)) const;
+    const std::vector<glm::mat4>& getFinalBoneMatrices() const { return skinPalette; }
+
+    // Skin matrices (globalInverse * global * offset) for every bone in
+    // one pass, written into the persistent palette Draw uploads
+    void updateSkinPalette(const glm::mat4* globalPose, size_t count);
+    void updateSkinPalette(const std::vector<glm::mat4>& globalPose) {
+        updateSkinPalette(globalPose.data(), globalPose.size());
+    }
+
+    // Same maths into caller storage, e.g. a precomputed palette table
+    void computeSkinPalette(const glm::mat4* globalPose, size_t count, glm::mat4* outPalette) const;
+
+    // Draws with a palette owned elsewhere (getBones().size() matrices,
+    // kept alive by the caller) instead of the model's own, until the
+    // next updateSkinPalette/setBoneTransform. nullptr copies the
+    // borrowed palette back in, for when its owner is about to free it.
+    // getSkinPalette() is whichever one Draw uploads.
+    void useSkinPalette(const glm::mat4* palette);
+    const glm::mat4* getSkinPalette() const { return externalPalette ? externalPalette : skinPalette.data(); }
     std::unordered_map<std::string, glm::mat4> boneLocalBindTransforms;
     glm::mat4 getBoneOffsetMatrix(const std::string& boneName) const;
     glm::mat4 getGlobalInverseTransform() const;
@@ -59,6 +91,9 @@ public:
     bool hasBone(const std::string& name) const;
     glm::mat4 getLocalBindPose(const std::string& boneName) const;
 
+    // Local bind pose of every bone, indexed like getBones()
+    const std::vector<glm::mat4>& getLocalBindPoses() const { return boneLocalBindPoses; }
+
     // Bind-pose offset with SCALE stripped out   (inverse( bindNoScale ))
     glm::mat4 getBoneOffsetMatrixNoScale(const std::string& boneName) const;
     const SkeletonPose* getBindPose() const { return bindPose.get(); }
@@ -70,6 +105,15 @@ private:
     std::string directory;
 
     std::vector<Bone> bones;
+    std::vector<int> boneOrder;
+
+    // Bone-indexed skinning data: offsets copied out of bones so the
+    // palette pass stays on contiguous matrices
+    std::vector<glm::mat4> boneOffsets;
+    std::vector<glm::mat4> skinPalette;
+    const glm::mat4* externalPalette = nullptr;
+    unsigned int paletteProgram = 0;    // shader the cached location belongs to
+    int paletteLocation = -1;
     std::unordered_map<std::string, glm::mat4> boneTransforms;
     std::unordered_map<std::string, int> boneMapping;
     
@@ -82,10 +126,12 @@ private:
 
 
     std::unordered_map<std::string, glm::mat4> boneGlobalBindPose;
+    std::vector<glm::mat4> boneLocalBindPoses;
 
 
 	
     void updateBoneTransforms(const aiNode* node, const glm::mat4& parentTransform);
+    void detachSkinPalette();
     std::string getBoneName(int index) const;
     std::unique_ptr<SkeletonPose> bindPose;
 
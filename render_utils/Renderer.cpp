@@ -7,6 +7,7 @@
 #include "../model/Camera.h"
 #include "../model/Model.h"
 #include "../shaders/ShaderManager.h"
+#include <algorithm>
 #include <random>
 #include "../setup/Globals.h"
 #include <imgui.h>
@@ -14,6 +15,7 @@
 #include <imgui_impl_opengl3.h>
 #include "../Animation/AnimationController.h"
 #include "../Animation/AnimationBatchSmoother.h"
+#include "../Animation/JitterAnalysis.h"
 
 
 // Static variable definitions
@@ -494,17 +496,25 @@ void Renderer::InitializeImGui(GLFWwindow* window) {
 
     Logger::log("ImGui initialized successfully.", Logger::INFO);
 }
+// Jitter heatmap state; rebuilt when the panel asks for it or after batch smoothing
+static JitterReport jitterReport;
+static bool jitterReportStale = true;
+
+// jitter_config.json watch: checked from the UI about once a second
+static bool watchJitterConfig = false;
+static double lastJitterConfigCheck = 0.0;
+
 // -----------------------------------------------------------------------------
 //  Renderer::RenderImGui
-//  Draw a combo box, reload a clip the first time its requested, bind it,
-//  and push the first-frame pose so theres no visible stall.
+//  Draw a combo box and request the picked clip. Loading runs in the
+//  background; the controller keeps playing the current clip and swaps at
+//  the start of the update() after the new one is ready.
 // -----------------------------------------------------------------------------
 void Renderer::RenderImGui()
 {
     if (!ImGui::GetCurrentContext())
         return;
 
-    extern Model* myModel;                       // <- already declared elsewhere
     extern AnimationController* animationController;
 
     ImGui::Begin("Animation Controller");
@@ -512,7 +522,7 @@ void Renderer::RenderImGui()
     /* 1. Clip names and file paths */
     static const char* animNames[] = { "Jab_Head", "Idle",  "Stance1" };
     static const char* animFiles[] = {
-       "animations/Jab_Head.fbx"
+       "animations/Jab_Head.fbx",
        "animations/Idle.fbx",
        "animations/Stance1.fbx",
     };
@@ -533,28 +543,14 @@ void Renderer::RenderImGui()
         const char* clipName = animNames[currentIndex];
         const char* clipPath = animFiles[currentIndex];
 
-        /* (a) Load only if we havent loaded this clip before */
-        if (!animationController->isClipLoaded(clipName))
-        {
-            if (!animationController->loadAnimation(clipName, clipPath, false))
-            {
-                Logger::log("Failed to load " + std::string(clipPath),
-                    Logger::ERROR);
-                ImGui::End();
-                return;
-            }
-        }
-
-        /* (b) Bind it for immediate playback */
-        animationController->setCurrentAnimation(clipName);
-
-        /* (c) Push first frame pose so no one-frame pop */
-        animationController->update(0.0f);
-        animationController->applyToModel(myModel);   // <- use the real model ptr
-
-        Logger::log("NOW PLAYING: " + std::string(clipName), Logger::INFO);
+        /* Non-blocking: loads in the background if needed, then the
+           controller swaps to it between frames */
+        animationController->requestAnimation(clipName, clipPath, true);
     }
 
+    if (animationController->isLoading(animNames[currentIndex]))
+        ImGui::Text("Loading %s...", animNames[currentIndex]);
+
     /* 5. Playback Controls */
     ImGui::Separator();
     ImGui::Text("Playback Options:");
@@ -562,8 +558,14 @@ void Renderer::RenderImGui()
     ImGui::Checkbox("Step Frame", &animationController->debugStep);
     ImGui::Checkbox("Rewind", &animationController->debugRewind);
     ImGui::Checkbox("Loop Playback", &animationController->loopPlayback); // <-- NEW!
+    ImGui::Checkbox("Baked Skin Palettes", &animationController->bakeSkinPalettes);
 
     ImGui::Text("Current Frame: %d", animationController->debugFrame);
+    ImGui::Text("Heap allocations last frame: %llu",
+        static_cast<unsigned long long>(animationController->getFrameAllocationCount()));
+    ImGui::Text("Frame arena: %zu / %zu bytes",
+        animationController->getFrameArena().getBytesUsed(),
+        animationController->getFrameArena().getCapacity());
 
     ImGui::Separator();
     ImGui::Text("Batch Tools:");
@@ -577,7 +579,7 @@ void Renderer::RenderImGui()
         {
             if (anim && anim->isLoaded())
             {
-                allAnims.push_back(anim);
+                allAnims.push_back(anim.get());
                 Logger::log("[BATCH] Queued animation: " + name, Logger::WARNING);
             }
             else
@@ -587,15 +589,143 @@ void Renderer::RenderImGui()
         }
 
         RunBatchSmoothing(allAnims);
+        jitterReportStale = true;
+    }
+
+    ImGui::Checkbox("Watch jitter_config.json", &watchJitterConfig);
+    ImGui::SameLine();
+    const bool reloadNow = ImGui::Button("Reload Jitter Config");
+    if (reloadNow || (watchJitterConfig && ImGui::GetTime() - lastJitterConfigCheck >= 1.0))
+    {
+        lastJitterConfigCheck = ImGui::GetTime();
+
+        std::vector<Animation*> allAnims;
+        for (const auto& [name, anim] : animationController->getAllAnimations())
+            allAnims.push_back(anim.get());
+
+        const Model* model = animationController->getModel();
+        if (model && ReloadJitterConfig(allAnims, *model) > 0)
+            jitterReportStale = true;
     }
     /* 6. store selection for next frame AFTER comparison */
     oldIndex = currentIndex;
 
     ImGui::End();
+
+    RenderJitterHeatmap();
+
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+// -----------------------------------------------------------------------------
+//  Renderer::RenderJitterHeatmap
+//  Suppressed jitter per loaded clip: one strip per bone group across the
+//  clip's frames (brighter = more of the group's bones fixed on that frame),
+//  then the busiest bones with their frame ranges. Replaces the
+//  heatmaps/ and summaries/ text files of the Python scripts.
+// -----------------------------------------------------------------------------
+void Renderer::RenderJitterHeatmap()
+{
+    extern AnimationController* animationController;
+
+    ImGui::Begin("Jitter Heatmap");
+
+    static int fixSet = 0;
+    static const char* fixSets[] = { "Suppression (pre-bake)", "Post-bake smoothing", "All fixes" };
+    if (ImGui::Combo("Fixes", &fixSet, fixSets, IM_ARRAYSIZE(fixSets)))
+        jitterReportStale = true;
+
+    if (ImGui::Button("Refresh"))
+        jitterReportStale = true;
+    ImGui::SameLine();
+    if (ImGui::Button("Export JSON"))
+        jitterReport.exportJson();
+
+    if (jitterReportStale)
+    {
+        JitterFilter filter;
+        if (fixSet == 1)
+            filter.fixMask = jitterFixBit(JitterFix::PostBakeClamp) | jitterFixBit(JitterFix::PostBakeSmooth);
+        else if (fixSet == 2)
+            filter.fixMask = ~0u;
+
+        std::vector<const Animation*> clips;
+        for (const auto& [name, anim] : animationController->getAllAnimations())
+            clips.push_back(anim.get());
+        jitterReport = JitterReport::build(clips, filter);
+        jitterReportStale = false;
+    }
+
+    if (jitterReport.empty())
+        ImGui::Text("No clips loaded.");
+
+    const float stripHeight = 12.0f;
+    for (const JitterClipReport& clip : jitterReport.getClips())
+    {
+        if (!ImGui::CollapsingHeader(clip.clip.c_str()) || clip.frameCount == 0)
+            continue;
+
+        ImGui::Text("%zu frames", clip.frameCount);
+
+        for (const JitterGroupStats& group : clip.groups)
+        {
+            if (group.bones == 0 && group.bonesHit == 0)
+                continue;
+
+            const std::vector<uint16_t>& heat = clip.heat[static_cast<size_t>(group.group)];
+            const float fullHeat = float(std::max<size_t>(1, std::max(group.bones, group.bonesHit)));
+
+            ImGui::Text("%-9s %5.1f%%", JitterTrace::getGroupName(group.group), group.rate * 100.0f);
+            ImGui::SameLine();
+
+            ImDrawList* draw = ImGui::GetWindowDrawList();
+            const ImVec2 origin = ImGui::GetCursorScreenPos();
+            const float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+            const float cell = width / float(clip.frameCount);
+
+            for (size_t f = 0; f < heat.size(); ++f)
+            {
+                const float level = std::min(1.0f, heat[f] / fullHeat);
+                const ImU32 color = ImGui::ColorConvertFloat4ToU32(
+                    ImVec4(0.15f + 0.85f * level, 0.15f + 0.35f * level * (1.0f - level), 0.15f, 1.0f));
+                draw->AddRectFilled(ImVec2(origin.x + f * cell, origin.y),
+                    ImVec2(origin.x + (f + 1) * cell, origin.y + stripHeight), color);
+            }
+            ImGui::Dummy(ImVec2(width, stripHeight));
+
+            if (ImGui::IsItemHovered())
+            {
+                const size_t f = std::min(heat.size() - 1,
+                    static_cast<size_t>((ImGui::GetIO().MousePos.x - origin.x) / cell));
+                ImGui::SetTooltip("frame %zu: %u of %zu bones", f, unsigned(heat[f]), group.bones);
+            }
+        }
+
+        ImGui::Separator();
+        const size_t shown = std::min<size_t>(clip.bones.size(), 12);
+        for (size_t b = 0; b < shown; ++b)
+        {
+            const JitterBoneStats& bone = clip.bones[b];
+
+            std::string ranges;
+            for (const JitterFrameRange& r : bone.ranges)
+            {
+                if (!ranges.empty())
+                    ranges += ", ";
+                ranges += (r.first == r.last) ? std::to_string(r.first)
+                    : std::to_string(r.first) + "-" + std::to_string(r.last);
+            }
+            ImGui::Text("%-16s %3zu frames %5.1f%%  %s", bone.bone.c_str(), bone.frames,
+                bone.rate * 100.0f, ranges.c_str());
+        }
+        if (clip.bones.size() > shown)
+            ImGui::Text("... %zu more bones", clip.bones.size() - shown);
+    }
+
+    ImGui::End();
+}
+
 
 void Renderer::ShutdownImGui() {
     if (!ImGui::GetCurrentContext()) {
@@ -46,6 +46,7 @@ public:
     static void renderLightingWithSSAO(unsigned int ssaoColorBuffer);
     static void InitializeImGui(GLFWwindow* window);
     static void RenderImGui();
+    static void RenderJitterHeatmap();
     static void ShutdownImGui();
     static void render(GLFWwindow* window, float deltaTime);
     static void BeginFrame();
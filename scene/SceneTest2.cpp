@@ -78,13 +78,12 @@ void SceneTest2(GLFWwindow* window) {
         glm::mat4 modelMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f));
         activeShader->setMat4("model", modelMatrix);
 
-        // Explicitly set bone transformations for animation (critical step)
-        activeShader->setMat4Array("boneTransforms", myModel->getFinalBoneMatrices());
+        // Bone palette is uploaded by Model::Draw
 
         // Matrix Logging
-        Logger::log("Model matrix explicitly logged: " + glm::to_string(modelMatrix), Logger::INFO);
-        Logger::log("View matrix explicitly logged: " + glm::to_string(camera.GetViewMatrix()), Logger::INFO);
-        Logger::log("Projection matrix explicitly logged: " + glm::to_string(camera.ProjectionMatrix), Logger::INFO);
+        LOG_DEBUG(Logger::Render, "Model matrix explicitly logged: " + glm::to_string(modelMatrix));
+        LOG_DEBUG(Logger::Render, "View matrix explicitly logged: " + glm::to_string(camera.GetViewMatrix()));
+        LOG_DEBUG(Logger::Render, "Projection matrix explicitly logged: " + glm::to_string(camera.ProjectionMatrix));
 
         glDisable(GL_CULL_FACE);
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -35,10 +35,11 @@ void SceneTest3(GLFWwindow* window) {
 
     // Initialize the animation controller
     animationController = new AnimationController(myModel);
-    animationController->loadAnimation("Jab_Head", "animations/Jab_Head.fbx");
+    animationController->loadAnimations({
+        { "Jab_Head", "animations/Jab_Head.fbx" },
+        { "Idle",     "animations/Idle.fbx" },
+        { "Stance1",  "animations/Stance1.fbx" } });
     animationController->getAllAnimations().at("Jab_Head")->suppressPostBakeJitter(); // <- Right leg smoothing
-    animationController->loadAnimation("Idle", "animations/Idle.fbx");
-    animationController->loadAnimation("Stance1", "animations/Stance1.fbx");
     animationController->setCurrentAnimation("Jab_Head"); // <- Visually test smoothed animation
     animationController->loopPlayback = true;
     Logger::log("INFO: Set current animation to Jab_Head.", Logger::INFO);
@@ -78,10 +79,10 @@ void SceneTest3(GLFWwindow* window) {
             if (ImGui::Button("Step")) animationController->debugStep = true;
             if (ImGui::Button("Rewind")) animationController->debugRewind = true;
 
-            const auto& keyframes = animationController->getKeyframes();
-            if (!keyframes.empty()) {
+            const int frameCount = animationController->getFrameCount();
+            if (frameCount > 0) {
                 ImGui::SliderInt("Frame", &animationController->debugFrame, 0,
-                    static_cast<int>(keyframes.size()) - 1, "%d");
+                    frameCount - 1, "%d");
             }
             ImGui::End();
         }
@@ -101,7 +102,6 @@ void SceneTest3(GLFWwindow* window) {
             glm::radians(-90.0f),
             glm::vec3(1.0f, 0.0f, 0.0f));
         activeShader->setMat4("model", modelMatrix);
-        activeShader->setMat4Array("boneTransforms", myModel->getFinalBoneMatrices());
 
         glDisable(GL_CULL_FACE);
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
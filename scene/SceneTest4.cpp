@@ -0,0 +1,207 @@
+// SceneTest4.cpp
+#include "SceneTest4.h"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "../common_utils/Logger.h"
+#include "../model/Camera.h"
+#include "../shaders/ShaderManager.h"
+#include "../model/Model.h"
+#include "../render_utils/Renderer.h"
+#include "../setup/Globals.h"
+#include "../input/InputManager.h"
+#include "../animation/AnimationController.h"
+#include "../animation/AnimationWorld.h"
+#include "../animation/ClipLibrary.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <imgui.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    const char* const kClipNames[] = { "Jab_Head", "Idle", "Stance1" };
+
+    struct ThreadSample
+    {
+        unsigned threads = 0;
+        double msPerFrame = 0.0;
+    };
+
+    // Rebuilds the crowd: every character shares clipSource's clips and
+    // starts on its own clip and frame so the poses differ
+    void populate(AnimationWorld& world, Model* model, const AnimationController& clipSource,
+        int characterCount, bool bakeSkinPalettes)
+    {
+        world.clear();
+        for (int i = 0; i < characterCount; ++i)
+        {
+            AnimationController& character = world.addCharacter(model);
+            character.shareClips(clipSource);
+            character.setCurrentAnimation(kClipNames[i % 3]);
+            character.loopPlayback = true;
+            character.bakeSkinPalettes = bakeSkinPalettes;
+            const int frames = character.getFrameCount();
+            character.debugFrame = frames > 0 ? (i * 7) % frames : 0;
+        }
+        Logger::log("Crowd: " + std::to_string(characterCount) + " characters, " +
+            std::to_string(ClipLibrary::shared().getClipCount()) + " shared clips", Logger::INFO);
+    }
+
+    // Animation time per frame for 1..hardware threads, at 60 Hz steps
+    std::vector<ThreadSample> sweepThreads(AnimationWorld& world)
+    {
+        const unsigned restore = world.getThreadSetting();
+        const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        const int warmup = 10;
+        const int frames = 120;
+
+        std::vector<ThreadSample> samples;
+        for (unsigned threads = 1; threads <= maxThreads; ++threads)
+        {
+            world.setThreadCount(threads);
+            for (int i = 0; i < warmup; ++i)
+                world.update(1.0f / 60.0f);
+
+            double total = 0.0;
+            for (int i = 0; i < frames; ++i)
+            {
+                world.update(1.0f / 60.0f);
+                total += world.getLastUpdateMs();
+            }
+            samples.push_back({ threads, total / frames });
+        }
+        world.setThreadCount(restore);
+
+        for (const ThreadSample& sample : samples)
+        {
+            char line[128];
+            std::snprintf(line, sizeof(line), "Crowd sweep: %zu characters, %u threads: %.3f ms/frame (x%.2f)",
+                world.getCharacterCount(), sample.threads, sample.msPerFrame,
+                samples.front().msPerFrame / std::max(sample.msPerFrame, 1e-6));
+            Logger::log(line, Logger::INFO);
+        }
+        return samples;
+    }
+
+} // namespace
+
+void SceneTest4(GLFWwindow* window, int characterCount) {
+    Camera camera;
+    float lastFrame = 0.0f;
+    float deltaTime = 0.0f;
+
+    Logger::log("Entering SceneTest4 (crowd stress test).", Logger::INFO);
+
+    // One model: the characters share its meshes and draw with their own palettes
+    std::unique_ptr<Model> myModel = std::make_unique<Model>("CharacterModelTPose w shorts.fbx");
+    camera.setCameraToFitModel(*myModel);
+
+    // Loads the clips once; the crowd binds them through shareClips
+    AnimationController clipSource(myModel.get());
+    clipSource.loadAnimations({
+        { "Jab_Head", "animations/Jab_Head.fbx" },
+        { "Idle",     "animations/Idle.fbx" },
+        { "Stance1",  "animations/Stance1.fbx" } });
+    clipSource.getAllAnimations().at("Jab_Head")->suppressPostBakeJitter();
+
+    AnimationWorld world;
+    bool bakeSkinPalettes = false;
+    bool drawCharacters = true;
+    int threadCount = static_cast<int>(world.getThreadCount());
+    characterCount = std::max(1, characterCount);
+    populate(world, myModel.get(), clipSource, characterCount, bakeSkinPalettes);
+
+    // Renderer's debug panels follow the first character
+    ::myModel = myModel.get();
+    ::animationController = &world.getController(0);
+
+    const float spacing = myModel->getBoundingBoxRadius() * 1.5f;
+    std::vector<ThreadSample> sweep;
+    double averageMs = 0.0;
+
+    while (!glfwWindowShouldClose(window)) {
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        InputManager::processInput(window, deltaTime);
+        Renderer::BeginFrame();
+
+        // Every character's sampling, global pose and palette; returns
+        // once all are done
+        world.update(deltaTime);
+        averageMs = averageMs * 0.95 + world.getLastUpdateMs() * 0.05;
+
+        ImGui::Begin("Crowd");
+        ImGui::Text("Animation: %.3f ms (avg %.3f) for %zu characters on %u threads",
+            world.getLastUpdateMs(), averageMs, world.getCharacterCount(), world.getThreadCount());
+        ImGui::SliderInt("Characters", &characterCount, 1, 1024);
+        if (ImGui::IsItemDeactivatedAfterEdit())
+        {
+            populate(world, myModel.get(), clipSource, characterCount, bakeSkinPalettes);
+            ::animationController = &world.getController(0);
+        }
+        if (ImGui::SliderInt("Threads", &threadCount, 1,
+            static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))))
+            world.setThreadCount(static_cast<unsigned>(threadCount));
+        if (ImGui::Checkbox("Baked Skin Palettes", &bakeSkinPalettes))
+            for (size_t i = 0; i < world.getCharacterCount(); ++i)
+                world.getController(i).bakeSkinPalettes = bakeSkinPalettes;
+        ImGui::Checkbox("Draw Characters", &drawCharacters);
+        if (ImGui::Button("Thread Sweep"))
+            sweep = sweepThreads(world);
+        for (const ThreadSample& sample : sweep)
+            ImGui::Text("%2u threads: %.3f ms/frame (x%.2f)", sample.threads, sample.msPerFrame,
+                sweep.front().msPerFrame / std::max(sample.msPerFrame, 1e-6));
+        ImGui::End();
+
+        Shader* activeShader = ShaderManager::boneShader;
+        if (!activeShader || !activeShader->isCompiled()) {
+            Logger::log("WARNING: Bone shader failed! Falling back to lighting shader.", Logger::WARNING);
+            activeShader = ShaderManager::lightingShader;
+        }
+
+        activeShader->use();
+        activeShader->setMat4("view", camera.GetViewMatrix());
+        activeShader->setMat4("projection", camera.ProjectionMatrix);
+
+        glDisable(GL_CULL_FACE);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+        if (drawCharacters)
+        {
+            // Square grid, centred on x and receding from the camera
+            const size_t count = world.getCharacterCount();
+            const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+            for (size_t i = 0; i < count; ++i)
+            {
+                const glm::mat4* palette = world.getSkinPalette(i);
+                if (!palette)
+                    continue;
+
+                const float x = (static_cast<int>(i) % columns - (columns - 1) * 0.5f) * spacing;
+                const float z = -static_cast<float>(static_cast<int>(i) / columns) * spacing;
+                glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(x, 0.0f, z));
+                modelMatrix = glm::rotate(modelMatrix, glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+                activeShader->setMat4("model", modelMatrix);
+
+                myModel->useSkinPalette(palette);
+                myModel->Draw(*activeShader);
+            }
+            // The palettes are rewritten by the next update
+            myModel->useSkinPalette(nullptr);
+        }
+
+        Renderer::RenderImGui();
+        Renderer::EndFrame(window);
+    }
+
+    ::animationController = nullptr;
+    ::myModel = nullptr;
+    world.clear();
+    Logger::log("Exiting SceneTest4.", Logger::INFO);
+}
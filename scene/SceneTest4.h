@@ -0,0 +1,11 @@
+// SceneTest4.h
+#ifndef SCENETEST4_H
+#define SCENETEST4_H
+
+#include <GLFW/glfw3.h>
+
+// Crowd stress test: characterCount copies of the SceneTest3 character,
+// animated in parallel by an AnimationWorld
+void SceneTest4(GLFWwindow* window, int characterCount);
+
+#endif // SCENETEST4_H
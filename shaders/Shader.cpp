@@ -135,3 +135,13 @@ void Shader::setMat4Array(const std::string& name, const std::vector<glm::mat4>&
     }
     glUniformMatrix4fv(location, matrices.size(), GL_FALSE, glm::value_ptr(matrices[0]));
 }
+
+GLint Shader::getUniformLocation(const std::string& name) const {
+    return glGetUniformLocation(ID, name.c_str());
+}
+
+void Shader::setMat4Array(GLint location, const glm::mat4* matrices, size_t count) const {
+    if (location == -1 || count == 0)
+        return;
+    glUniformMatrix4fv(location, static_cast<GLsizei>(count), GL_FALSE, glm::value_ptr(matrices[0]));
+}
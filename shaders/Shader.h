@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <string>
+#include <vector>
 
 class Shader {
 public:
@@ -30,6 +31,10 @@ public:
 
     void setMat4Array(const std::string& name, const std::vector<glm::mat4>& matrices) const;
 
+    // For per-frame uploads: look the location up once, then set by it
+    GLint getUniformLocation(const std::string& name) const;
+    void setMat4Array(GLint location, const glm::mat4* matrices, size_t count) const;
+
 
 private:
     bool compiled;